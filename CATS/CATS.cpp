@@ -40,17 +40,28 @@ CATS::CATS():
     MaxRho = 16;
     MaxPw = 256;
     OnlyNumPw = NULL;
-    //MaxNumThreads = 32767;
-    MaxNumThreads = 1;
+    OwnExecution = new CATSexecution(1);
+    Execution = OwnExecution;
     ExcludeFailedConvergence = true;
+    AdaptiveMomBins = 0;
+    IncrementalTotWaveFun = 0;
+    PotTableNumRad = 0;
+    PotTableTolerance = 1e-4;
+    FixedGridNumRad = 0;
+    FixedGridNumCosTh = 1;
+    NumFixedGridPts = 0;
+    FixedGridTheta = false;
+    FixedGridSourceError = 0;
     GridMinDepth = 7;
     GridMaxDepth = 0;
     GridEpsilon = 0;
+    GridQuadrature = 1;
     NumPairs = 0;
     WeightIp = NULL;
     WeightIpError = NULL;
     LoadedData = false;
     SourceGridReady = false;
+    SourceFunChanged = false;
     SourceUpdated = false;
     ComputedWaveFunction = false;
     ComputedCorrFunction = false;
@@ -81,15 +92,30 @@ CATS::CATS():
     NumPW = NULL;
     MomBin = NULL;
     MomBinCenter = NULL;
+    MomBinInvStep = 0;
+    MomBinLogScale = false;
     IpBin = NULL;
+    IpBinInvStep = 0;
+    IpBinLogScale = false;
     ChannelWeight = NULL;
     SavedWaveFunBins = NULL;
     PhaseShift = NULL;
     PhaseShiftF = NULL;
     WaveFunRad = NULL;
     WaveFunctionU = NULL;
+    WaveFunCapacity = NULL;
+    WaveFunValid = NULL;
+    PwChanged = NULL;
+    WaveFunUniBin = NULL;
+    WaveFunUniStep = NULL;
+    ChPwOffset = NULL;
+    NumChPw = 0;
     MomBinConverged = NULL;
+    MomBinSelected = NULL;
+    MomBinStage = NULL;
     InputFileName = NULL;
+    WaveFunctionCache = NULL;
+    WaveFunctionCacheId = 0;
     RelativeMomentum = NULL;
     RelativePosition = NULL;
     RelativeCosTheta = NULL;
@@ -102,12 +128,37 @@ CATS::CATS():
     BaseSourceGrid = NULL;
     kSourceGrid = NULL;
     WaveFunction2 = NULL;
+    WaveFun2Status = NULL;
+    WaveFun2NumIncr = NULL;
+    PwTerm = NULL;
+    PwAmplitude = NULL;
+    PwTermValid = NULL;
+    PotTable = NULL;
+    PotTableStatus = NULL;
+    PotTableStep = 0;
+    RefPartialWave = NULL;
+    RefPwOffset = NULL;
+    RefPwRad = NULL;
+    RefPwNumGridPts = 0;
+    RefPwQ1Q2 = 0;
+    RefPwRedMass = 0;
+    RefPwMaxPw = 0;
+    RefPwTheta = false;
+    RefPwMaxMemory = 256;
+    RefPwMemory = 0;
     kbSourceGrid = NULL;
+    FixedGridRad = NULL;
+    FixedGridCosTh = NULL;
+    FixedGridSize = NULL;
+    FixedGridSource = NULL;
 
     ShortRangePotential = NULL;
+    ShortRangePotentialBatch = NULL;
 
     AnalyticSource = NULL;
+    AnalyticSourceBatch = NULL;
     ForwardedSource = NULL;
+    ThreadSafeSource = false;
 
     kCorrFun=NULL;
     kCorrFunErr=NULL;
@@ -124,12 +175,8 @@ CATS::CATS():
     //NumExtWfRadBins = NULL;
     //ExtWfRadBins = NULL;
 
-    RefPartWave = NULL;
-    SolvedPartWave = NULL;
-    LegPol = NULL;
 
     CPF = NULL;
-DEBUG=-1;
     SetIpBins(1, -1000, 1000);
 
 //SourceHistoTemp.SetUp(1);
@@ -147,13 +194,13 @@ CATS::~CATS(){
     if(ChannelWeight) {delete[]ChannelWeight; ChannelWeight=NULL;}
     if(OnlyNumPw) {delete[]OnlyNumPw; OnlyNumPw=NULL;}
     if(InputFileName) {delete[]InputFileName; InputFileName=NULL;}
+    if(WaveFunctionCache) {delete[]WaveFunctionCache; WaveFunctionCache=NULL;}
     if(BaseSourceGrid){delete BaseSourceGrid; BaseSourceGrid=NULL;}
-    if(RefPartWave){delete[]RefPartWave; RefPartWave=NULL;}
-    if(SolvedPartWave){delete[]SolvedPartWave; SolvedPartWave=NULL;}
-    if(LegPol){delete[]LegPol; LegPol=NULL;}
     if(CPF){delete[]CPF; CPF=NULL;}
+    if(OwnExecution){delete OwnExecution; OwnExecution=NULL;}
     if(AnaSourcePar){delete AnaSourcePar; AnaSourcePar=NULL;}
     //if(ForwardedSourcePar){delete ForwardedSourcePar;ForwardedSourcePar=NULL;}
+    if(ShortRangePotentialBatch){delete[]ShortRangePotentialBatch;ShortRangePotentialBatch=NULL;}
     if(PotPar){delete[]PotPar;PotPar=NULL;}
     if(ExternalWF){delete[]ExternalWF;ExternalWF=NULL;}
     if(ExternalPS){delete[]ExternalPS;ExternalPS=NULL;}
@@ -185,24 +232,18 @@ void CATS::DelIp(){
 }
 
 void CATS::DelMomChPw(){
+    //the layout of PotTable depends on the number of PWs
+    DelPotTables();
     if(SavedWaveFunBins){
+        for(unsigned uWf=0; uWf<NumMomBins*NumChPw; uWf++){
+            if(WaveFunRad[uWf]) delete [] WaveFunRad[uWf];
+            if(WaveFunctionU[uWf]) delete [] WaveFunctionU[uWf];
+        }
         for(unsigned uMomBin=0; uMomBin<NumMomBins; uMomBin++){
             for(unsigned short usCh=0; usCh<NumCh; usCh++){
-                for(unsigned short usPW=0; usPW<NumPW[usCh]; usPW++){
-                    if(WaveFunRad[uMomBin][usCh][usPW])
-                        delete [] WaveFunRad[uMomBin][usCh][usPW];
-                    if(WaveFunctionU[uMomBin][usCh][usPW])
-                        delete [] WaveFunctionU[uMomBin][usCh][usPW];
-                }
-                delete [] SavedWaveFunBins[uMomBin][usCh];
                 delete [] PhaseShift[uMomBin][usCh];
-                delete [] WaveFunRad[uMomBin][usCh];
-                delete [] WaveFunctionU[uMomBin][usCh];
             }
-            delete [] SavedWaveFunBins[uMomBin];
             delete [] PhaseShift[uMomBin];
-            delete [] WaveFunRad[uMomBin];
-            delete [] WaveFunctionU[uMomBin];
         }
 
         for(unsigned short usCh=0; usCh<NumCh; usCh++){
@@ -217,7 +258,17 @@ void CATS::DelMomChPw(){
         delete [] PhaseShiftF; PhaseShiftF=NULL;
         delete [] WaveFunRad; WaveFunRad=NULL;
         delete [] WaveFunctionU; WaveFunctionU=NULL;
-    }
+        delete [] WaveFunCapacity; WaveFunCapacity=NULL;
+        delete [] WaveFunValid; WaveFunValid=NULL;
+        delete [] PwChanged; PwChanged=NULL;
+        delete [] PwTermValid; PwTermValid=NULL;
+        delete [] WaveFunUniBin; WaveFunUniBin=NULL;
+        delete [] WaveFunUniStep; WaveFunUniStep=NULL;
+        delete [] ChPwOffset; ChPwOffset=NULL;
+        NumChPw = 0;
+    }
+    //the layout of PwTerm depends on the number of PWs
+    DelPwTerms();
     //if(ExternalWF){
     //    for(unsigned short usCh=0; usCh<NumCh; usCh++){
     //        if(ExternalWF[usCh]){delete [] ExternalWF[usCh]; ExternalWF[usCh]=NULL;}
@@ -229,17 +280,58 @@ void CATS::DelMomChPw(){
 void CATS::DelMomCh(){
     if(WaveFunction2){
         for(unsigned uMomBin=0; uMomBin<NumMomBins; uMomBin++){
-            for(unsigned uGrid=0; uGrid<NumGridPts; uGrid++){
-                delete [] WaveFunction2[uMomBin][uGrid];
-            }
             delete [] WaveFunction2[uMomBin];
         }
         delete [] WaveFunction2; WaveFunction2 = NULL;
     }
+    if(WaveFun2Status){delete [] WaveFun2Status; WaveFun2Status = NULL;}
+    if(WaveFun2NumIncr){delete [] WaveFun2NumIncr; WaveFun2NumIncr = NULL;}
+    DelPwTerms();
+    DelRefPartialWaves();
+}
+
+void CATS::DelPwTerms(){
+    if(PwTerm){
+        for(unsigned uMomBin=0; uMomBin<NumMomBins; uMomBin++){
+            delete [] PwTerm[uMomBin];
+        }
+        delete [] PwTerm; PwTerm = NULL;
+    }
+    if(PwAmplitude){
+        for(unsigned uMomBin=0; uMomBin<NumMomBins; uMomBin++){
+            delete [] PwAmplitude[uMomBin];
+        }
+        delete [] PwAmplitude; PwAmplitude = NULL;
+    }
+}
+
+void CATS::DelPotTables(){
+    if(PotTable){
+        for(unsigned uChPw=0; uChPw<NumChPw; uChPw++){
+            if(PotTable[uChPw]) delete [] PotTable[uChPw];
+        }
+        delete [] PotTable; PotTable = NULL;
+        delete [] PotTableStatus; PotTableStatus = NULL;
+    }
+}
+
+void CATS::DelRefPartialWaves(){
+    if(RefPartialWave){
+        for(unsigned uMomBin=0; uMomBin<NumMomBins; uMomBin++){
+            if(RefPartialWave[uMomBin]) delete [] RefPartialWave[uMomBin];
+            if(RefPwOffset[uMomBin]) delete [] RefPwOffset[uMomBin];
+        }
+        delete [] RefPartialWave; RefPartialWave = NULL;
+        delete [] RefPwOffset; RefPwOffset = NULL;
+    }
+    if(RefPwRad){delete [] RefPwRad; RefPwRad = NULL;}
+    RefPwNumGridPts = 0;
+    RefPwMemory = 0;
 }
 
 void CATS::DelMom(){
     if(MomBinConverged) {delete [] MomBinConverged; MomBinConverged=NULL;}
+    if(MomBinStage) {delete [] MomBinStage; MomBinStage=NULL;}
     if(LoadedPairsPerMomBin) {delete [] LoadedPairsPerMomBin; LoadedPairsPerMomBin = NULL;}
     if(kCorrFun){
         delete [] kCorrFun; kCorrFun=NULL;
@@ -280,6 +372,38 @@ void CATS::DelMomIp(){
     }
 }
 
+void CATS::DelSourceGrid(){
+    if(BaseSourceGrid){
+        delete BaseSourceGrid; BaseSourceGrid=NULL;
+    }
+    if(kSourceGrid){
+        for(unsigned uMomBin=0; uMomBin<NumMomBins; uMomBin++){
+            if(kSourceGrid[uMomBin]) delete kSourceGrid[uMomBin];
+        }
+        delete [] kSourceGrid; kSourceGrid=NULL;
+    }
+    if(kbSourceGrid){
+        for(unsigned uMomBin=0; uMomBin<NumMomBins; uMomBin++){
+            if(!kbSourceGrid[uMomBin]) break;
+            for(unsigned uIpBin=0; uIpBin<NumIpBins; uIpBin++){
+                if(kbSourceGrid[uMomBin][uIpBin]) delete kbSourceGrid[uMomBin][uIpBin];
+            }
+            delete [] kbSourceGrid[uMomBin];
+        }
+        delete [] kbSourceGrid; kbSourceGrid=NULL;
+    }
+}
+
+void CATS::DelFixedGrid(){
+    if(FixedGridRad){
+        delete [] FixedGridRad; FixedGridRad=NULL;
+        delete [] FixedGridCosTh; FixedGridCosTh=NULL;
+        delete [] FixedGridSize; FixedGridSize=NULL;
+        delete [] FixedGridSource; FixedGridSource=NULL;
+    }
+    NumFixedGridPts = 0;
+}
+
 //this only deletes whatever is related to a single partial wave, including the potential
 void CATS::DelPotPw(const unsigned short& usCh, const unsigned short& usPW){
     if(usCh>=NumCh){
@@ -291,6 +415,9 @@ void CATS::DelPotPw(const unsigned short& usCh, const unsigned short& usPW){
     if(ShortRangePotential&&ShortRangePotential[usCh]&&ShortRangePotential[usCh][usPW]){
         ShortRangePotential[usCh][usPW] = NULL;
     }
+    if(ShortRangePotentialBatch&&ShortRangePotentialBatch[usCh]){
+        ShortRangePotentialBatch[usCh][usPW] = NULL;
+    }
     if(PotPar&&PotPar[usCh]&&PotPar[usCh][usPW]){
         delete PotPar[usCh][usPW];
         PotPar[usCh][usPW] = NULL;
@@ -316,6 +443,10 @@ void CATS::DelPotCh(const unsigned short& usCh){
         delete[]ShortRangePotential[usCh];
         ShortRangePotential[usCh] = NULL;
     }
+    if(ShortRangePotentialBatch&&ShortRangePotentialBatch[usCh]){
+        delete[]ShortRangePotentialBatch[usCh];
+        ShortRangePotentialBatch[usCh] = NULL;
+    }
     if(PotPar&&PotPar[usCh]){
         delete[]PotPar[usCh];
         PotPar[usCh] = NULL;
@@ -348,6 +479,7 @@ void CATS::DelAll(){
     for(unsigned short usCh=0; usCh<NumCh; usCh++){DelPotCh(usCh);}
     DelAllMom();
     DelAllIp();
+    DelFixedGrid();
 }
 
 void CATS::SetRedMass(const double& redMass){
@@ -425,14 +557,17 @@ void CATS::SetNumChannels(const unsigned short& numCh){
         DelPotCh(usCh);
     }
     if(ShortRangePotential){delete[]ShortRangePotential;}
+    if(ShortRangePotentialBatch){delete[]ShortRangePotentialBatch;}
 
     ShortRangePotential = new CatsPotential* [numCh];
+    ShortRangePotentialBatch = new CatsPotentialBatch* [numCh];
     PotPar = new CATSparameters** [numCh];
     ExternalWF = new DLM_Histo<complex<double>>** [numCh];
     ExternalPS = new DLM_Histo<complex<double>>** [numCh];
 
     for(unsigned short usCh=0; usCh<numCh; usCh++){
         ShortRangePotential[usCh] = NULL;
+        ShortRangePotentialBatch[usCh] = NULL;
         PotPar[usCh] = NULL;
         ExternalWF[usCh] = NULL;
         ExternalPS[usCh] = NULL;
@@ -480,48 +615,53 @@ void CATS::SetNumPW(const unsigned short& usCh, const unsigned short& numPW){
     NumPW[usCh] = numPW;
 
     ShortRangePotential[usCh] = new CatsPotential [numPW];
+    ShortRangePotentialBatch[usCh] = new CatsPotentialBatch [numPW];
     PotPar[usCh] = new CATSparameters* [numPW];
     ExternalWF[usCh] = new DLM_Histo<complex<double>>* [numPW];
     ExternalPS[usCh] = new DLM_Histo<complex<double>>* [numPW];
     for(unsigned short usPW=0; usPW<numPW; usPW++){
         ShortRangePotential[usCh][usPW] = 0;
+        ShortRangePotentialBatch[usCh][usPW] = NULL;
         PotPar[usCh][usPW] = NULL;
         ExternalWF[usCh][usPW] = NULL;
         ExternalPS[usCh][usPW] = NULL;
     }
 
     //Reserve memory for the output
-    SavedWaveFunBins = new unsigned** [NumMomBins];
+    //the radial wave functions of all mom/pol/pw are accessed with a single index (WfIndex)
+    ChPwOffset = new unsigned [NumCh];
+    NumChPw = 0;
+    for(unsigned short usCh=0; usCh<NumCh; usCh++){
+        ChPwOffset[usCh] = NumChPw;
+        NumChPw += NumPW[usCh];
+    }
+    SavedWaveFunBins = new unsigned [NumMomBins*NumChPw];
+    WaveFunCapacity = new unsigned [NumMomBins*NumChPw];
+    WaveFunValid = new bool [NumMomBins*NumChPw];
+    PwTermValid = new bool [NumMomBins*NumChPw];
+    PwChanged = new unsigned char [NumChPw];
+    for(unsigned uChPw=0; uChPw<NumChPw; uChPw++) PwChanged[uChPw] = 0;
+    WaveFunUniBin = new unsigned [NumMomBins*NumChPw];
+    WaveFunUniStep = new double [NumMomBins*NumChPw];
+    WaveFunRad = new double* [NumMomBins*NumChPw];
+    WaveFunctionU = new complex<double>* [NumMomBins*NumChPw];
+    for(unsigned uWf=0; uWf<NumMomBins*NumChPw; uWf++){
+        SavedWaveFunBins[uWf] = 0;
+        WaveFunCapacity[uWf] = 0;
+        WaveFunValid[uWf] = false;
+        PwTermValid[uWf] = false;
+        WaveFunUniBin[uWf] = 0;
+        WaveFunUniStep[uWf] = 0;
+        WaveFunRad[uWf] = NULL;
+        WaveFunctionU[uWf] = NULL;
+    }
     PhaseShift = new double** [NumMomBins];
-    WaveFunRad = new double*** [NumMomBins];
-    WaveFunctionU = new complex<double>*** [NumMomBins];
-    //ExternalWF = new const complex<double>*** [NumMomBins];
-    //NumExtWfRadBins = new unsigned** [NumMomBins];
-    //ExtWfRadBins = new const double*** [NumMomBins];
     for(unsigned uMomBin=0; uMomBin<NumMomBins; uMomBin++){
-        SavedWaveFunBins[uMomBin] = new unsigned* [NumCh];
         PhaseShift[uMomBin] = new double* [NumCh];
-        WaveFunRad[uMomBin] = new double** [NumCh];
-        WaveFunctionU[uMomBin] = new complex<double>** [NumCh];
-        //ExternalWF[uMomBin] = new const complex<double>** [NumCh];
-        //NumExtWfRadBins[uMomBin] = new unsigned* [NumCh];
-        //ExtWfRadBins[uMomBin] = new const double** [NumCh];
         for(unsigned short usCh=0; usCh<NumCh; usCh++){
-            SavedWaveFunBins[uMomBin][usCh] = new unsigned [NumPW[usCh]];
             PhaseShift[uMomBin][usCh] = new double [NumPW[usCh]];
-            WaveFunRad[uMomBin][usCh] = new double* [NumPW[usCh]];
-            WaveFunctionU[uMomBin][usCh] = new complex<double>* [NumPW[usCh]];
-            //ExternalWF[uMomBin][usCh] = new const complex<double>* [NumPW[usCh]];
-            //NumExtWfRadBins[uMomBin][usCh] = new unsigned [NumPW[usCh]];
-            //ExtWfRadBins[uMomBin][usCh] = new const double* [NumPW[usCh]];
             for(unsigned short usPW=0; usPW<NumPW[usCh]; usPW++){
-                SavedWaveFunBins[uMomBin][usCh][usPW] = 0;
                 PhaseShift[uMomBin][usCh][usPW] = 0;
-                WaveFunRad[uMomBin][usCh][usPW] = NULL;
-                WaveFunctionU[uMomBin][usCh][usPW] = NULL;
-                //ExternalWF[uMomBin][usCh][usPW] = NULL;
-                //NumExtWfRadBins[uMomBin][usCh][usPW] = 0;
-                //ExtWfRadBins[uMomBin][usCh][usPW] = NULL;
             }
         }
     }
@@ -619,13 +759,17 @@ void CATS::SetMomBins(const unsigned& nummombins, const double* mombins, const d
         return;
     }
     //check if the momentum bins set are the same as before. If yes, change nothing
-    if(nummombins==NumMomBins){
+    if(nummombins==NumMomBins && MomBin){
         bool SameBinning = true;
-        for(unsigned uMomBin=0; uMomBin<NumMomBins; uMomBin++){
+        for(unsigned uMomBin=0; uMomBin<=NumMomBins; uMomBin++){
             SameBinning *= (mombins[uMomBin]==MomBin[uMomBin]);
+            if(bincenter && uMomBin<NumMomBins) SameBinning *= (bincenter[uMomBin]==MomBinCenter[uMomBin]);
+            else if(uMomBin<NumMomBins) SameBinning *= (0.5*(mombins[uMomBin]+mombins[uMomBin+1])==MomBinCenter[uMomBin]);
         }
         if(SameBinning) return;
     }
+    //the reference partial waves are computed for the old momenta
+    DelRefPartialWaves();
     if(nummombins!=NumMomBins || !MomBin){
         if(MomBin) {delete[]MomBin; MomBin=NULL;}
         if(MomBinCenter) {delete[]MomBinCenter; MomBinCenter=NULL;}
@@ -641,6 +785,7 @@ void CATS::SetMomBins(const unsigned& nummombins, const double* mombins, const d
     ComputedWaveFunction = false;
     ComputedCorrFunction = false;
     GamowCorrected = false;
+    MomBinInvStep = 0;
 
     for(unsigned uBin=0; uBin<=NumMomBins; uBin++){
         MomBin[uBin] = mombins[uBin];
@@ -657,6 +802,7 @@ void CATS::SetMomBins(const unsigned& nummombins, const double* mombins, const d
             return;
         }
     }
+    MomBinInvStep = UniformBinStep(MomBin,NumMomBins,MomBinLogScale);
 }
 void CATS::SetMomBins(const unsigned& nummombins, const double& MinMom, const double& MaxMom){
     if(!nummombins){
@@ -676,7 +822,8 @@ void CATS::SetMomBins(const unsigned& nummombins, const double& MinMom, const do
     }
     //check if the momentum bins set are the same as before. If yes, change nothing
     double BinWidth = (MaxMom-MinMom)/double(nummombins);
-    if(nummombins==NumMomBins && MomBin[0]==MinMom && MomBin[nummombins]==MinMom+double(nummombins)*BinWidth) return;
+    if(nummombins==NumMomBins && MomBin && MomBin[0]==MinMom && MomBin[nummombins]==MinMom+double(nummombins)*BinWidth) return;
+    DelRefPartialWaves();
     if(nummombins!=NumMomBins || !MomBin){
         if(MomBin) {delete[]MomBin; MomBin=NULL;}
         if(MomBinCenter) {delete[]MomBinCenter; MomBinCenter=NULL;}
@@ -696,6 +843,7 @@ void CATS::SetMomBins(const unsigned& nummombins, const double& MinMom, const do
         MomBin[uBin] = MinMom+double(uBin)*BinWidth;
         if(uBin!=NumMomBins) MomBinCenter[uBin] = MinMom+double(uBin)*BinWidth+0.5*BinWidth;
     }
+    MomBinInvStep = UniformBinStep(MomBin,NumMomBins,MomBinLogScale);
 }
 
 void CATS::SetIpBins(const unsigned& numBbins, const double* imppar){
@@ -724,6 +872,7 @@ void CATS::SetIpBins(const unsigned& numBbins, const double* imppar){
     for(unsigned uBin=0; uBin<=NumIpBins; uBin++){
         IpBin[uBin] = imppar[uBin];
     }
+    IpBinInvStep = UniformBinStep(IpBin,NumIpBins,IpBinLogScale);
 }
 void CATS::SetIpBins(const unsigned& numBbins, const double& MinImpPar, const double& MaxImpPar){
     if(!numBbins){
@@ -757,6 +906,7 @@ void CATS::SetIpBins(const unsigned& numBbins, const double& MinImpPar, const do
     for(unsigned uBin=0; uBin<=NumIpBins; uBin++){
         IpBin[uBin] = MinImpPar+double(uBin)*BinWidth;
     }
+    IpBinInvStep = UniformBinStep(IpBin,NumIpBins,IpBinLogScale);
 }
 
 void CATS::SetChannelWeight(const unsigned short& usCh, const double& weight){
@@ -852,6 +1002,9 @@ void CATS::SetOnlyNumericalPw(const unsigned short& usCh, const bool& val){
     }
     if(OnlyNumPw[usCh]==val) return;
     OnlyNumPw[usCh]=val;
+    if(WaveFun2Status){
+        for(unsigned uMomBin=0; uMomBin<NumMomBins; uMomBin++) WaveFun2Status[uMomBin*NumCh+usCh] = 0;
+    }
     ComputedCorrFunction = false;
 }
 bool CATS::GetOnlyNumericalPw(const unsigned short& usCh) const{
@@ -864,10 +1017,18 @@ bool CATS::GetOnlyNumericalPw(const unsigned short& usCh) const{
 }
 
 void CATS::SetMaxNumThreads(const unsigned short& maxnumthreads){
-    MaxNumThreads = maxnumthreads;
+    if(Execution!=OwnExecution && Notifications>=nWarning)
+        printf("\033[1;33mWARNING:\033[0m SetMaxNumThreads has no effect while an external execution context is set, use its SetNumThreads instead\n");
+    OwnExecution->SetNumThreads(maxnumthreads);
 }
 unsigned short CATS::GetMaxNumThreads() const{
-    return MaxNumThreads;
+    return Execution->GetNumThreads();
+}
+void CATS::SetExecution(CATSexecution* execution){
+    Execution = execution?execution:OwnExecution;
+}
+CATSexecution* CATS::GetExecution() const{
+    return Execution==OwnExecution?NULL:Execution;
 }
 
 void CATS::SetExcludeFailedBins(const bool& efb){
@@ -914,6 +1075,31 @@ void CATS::SetGridEpsilon(const double& val){
 double CATS::GetGridEpsilon() const{
     return GridEpsilon;
 }
+void CATS::SetGridQuadrature(const unsigned short& order){
+    unsigned short Order = order?order:1;
+    if(GridQuadrature==Order) return;
+    GridQuadrature = Order;
+    SourceGridReady = false;
+    SourceUpdated = false;
+    ComputedCorrFunction = false;
+}
+unsigned short CATS::GetGridQuadrature() const{
+    return GridQuadrature;
+}
+
+void CATS::SetFixedSourceGrid(const unsigned& numrad, const unsigned& numcosth){
+    unsigned NumCosTh = numcosth?numcosth:1;
+    if(FixedGridNumRad==numrad && FixedGridNumCosTh==NumCosTh) return;
+    FixedGridNumRad = numrad;
+    FixedGridNumCosTh = NumCosTh;
+    DelFixedGrid();
+    SourceGridReady = false;
+    SourceUpdated = false;
+    ComputedCorrFunction = false;
+}
+unsigned CATS::GetFixedSourceGrid() const{
+    return FixedGridNumRad;
+}
 
 void CATS::SetMomentumDependentSource(const bool& val){
     if(val==MomDepSource) return;
@@ -1009,16 +1195,6 @@ void CATS::SetThetaDependentSource(const bool& val){
     SourceGridReady = false;
     SourceUpdated = false;
     ComputedCorrFunction = false;
-    if(ThetaDependentSource && !RefPartWave){
-        RefPartWave = new complex<double> [MaxPw];
-        SolvedPartWave = new complex<double> [MaxPw];
-        LegPol = new double [MaxPw];
-    }
-    if(!ThetaDependentSource && RefPartWave){
-        delete [] RefPartWave; RefPartWave=NULL;
-        delete [] SolvedPartWave; SolvedPartWave=NULL;
-        delete [] LegPol; LegPol=NULL;
-    }
 }
 bool CATS::GetThetaDependentSource() const{
     return ThetaDependentSource;
@@ -1146,6 +1322,78 @@ void CATS::GetInputFileName(char* fname) const{
     strcpy(fname, InputFileName);
 }
 
+void CATS::SetWaveFunctionCache(const char* folder, const unsigned& PotentialId){
+    WaveFunctionCacheId = PotentialId;
+    if(WaveFunctionCache){
+        delete [] WaveFunctionCache;
+        WaveFunctionCache = NULL;
+    }
+    if(!folder || !strlen(folder)) return;
+    WaveFunctionCache = new char [strlen(folder)+1];
+    strcpy(WaveFunctionCache, folder);
+}
+
+void CATS::GetWaveFunctionCache(char* folder) const{
+    if(!WaveFunctionCache){
+        strcpy(folder, "");
+        return;
+    }
+    strcpy(folder, WaveFunctionCache);
+}
+
+unsigned CATS::GetWaveFunctionCacheId() const{
+    return WaveFunctionCacheId;
+}
+
+void CATS::SetAdaptiveMomBins(const double& tolerance){
+    double Tol = tolerance>0?tolerance:0;
+    if(AdaptiveMomBins==Tol) return;
+    AdaptiveMomBins = Tol;
+    if(MomBinStage) {delete [] MomBinStage; MomBinStage=NULL;}
+    ComputedWaveFunction = false;
+    ComputedCorrFunction = false;
+}
+double CATS::GetAdaptiveMomBins() const{
+    return AdaptiveMomBins;
+}
+void CATS::SetIncrementalTotWaveFun(const double& MaxMemoryMB){
+    double MaxMem = MaxMemoryMB>0?MaxMemoryMB:0;
+    if(IncrementalTotWaveFun==MaxMem) return;
+    IncrementalTotWaveFun = MaxMem;
+    //WaveFunction2 itself remains valid
+    DelPwTerms();
+}
+double CATS::GetIncrementalTotWaveFun() const{
+    return IncrementalTotWaveFun;
+}
+void CATS::SetRefPartialWaveMemory(const double& MaxMemoryMB){
+    double MaxMem = MaxMemoryMB>0?MaxMemoryMB:0;
+    if(RefPwMaxMemory==MaxMem) return;
+    RefPwMaxMemory = MaxMem;
+    //the tables are set up again (the total wave function is reevaluated, the result is the same)
+    DelRefPartialWaves();
+}
+double CATS::GetRefPartialWaveMemory() const{
+    return RefPwMaxMemory;
+}
+void CATS::SetTabulatedPotential(const unsigned& NumRad, const double& Tolerance){
+    //at least 4 points are needed for the spline
+    const unsigned NewNumRad = NumRad>=4?NumRad:0;
+    if(PotTableNumRad==NewNumRad && PotTableTolerance==fabs(Tolerance)) return;
+    PotTableNumRad = NewNumRad;
+    PotTableTolerance = fabs(Tolerance);
+    DelPotTables();
+    ComputedWaveFunction = false;
+    ComputedCorrFunction = false;
+}
+unsigned CATS::GetTabulatedPotential() const{
+    return PotTableNumRad;
+}
+bool CATS::GetMomBinSolved(const unsigned& WhichMomBin) const{
+    if(WhichMomBin>=NumMomBins) return false;
+    return !MomBinStage || MomBinStage[WhichMomBin];
+}
+
 unsigned CATS::GetNumPairsPerBin(const unsigned& uMomBin, const unsigned& uIpBin) const{
     if(uMomBin>=NumMomBins || uIpBin>=NumIpBins || !LoadedData) return 0;
     return LoadedPairsPerBin[uMomBin][uIpBin];
@@ -1220,13 +1468,13 @@ double CATS::GetCorrFun(const unsigned& WhichMomBin, double& Momentum) const{
 //the two points below the value of Momentum
 double CATS::EvalCorrFun(const double& Momentum) const{
     if(Momentum<MomBin[0] || Momentum>MomBin[NumMomBins]) return 0;
-    return EvalBinnedFun(Momentum, NumMomBins, MomBin, MomBinCenter, kCorrFun);
+    return EvalBinnedFun(Momentum, GetMomBin(Momentum), NumMomBins, MomBin, MomBinCenter, kCorrFun);
     //return EvalBinnedFun(Momentum, NumMomBins, MomBin, NULL, kCorrFun);
 }
 
 double CATS::EvalCorrFunErr(const double& Momentum) const{
     if(Momentum<MomBin[0] || Momentum>MomBin[NumMomBins]) return 0;
-    return EvalBinnedFun(Momentum, NumMomBins, MomBin, MomBinCenter, kCorrFunErr);
+    return EvalBinnedFun(Momentum, GetMomBin(Momentum), NumMomBins, MomBin, MomBinCenter, kCorrFunErr);
     //return EvalBinnedFun(Momentum, NumMomBins, MomBin, NULL, kCorrFunErr);
 }
 
@@ -1261,17 +1509,19 @@ double CATS::GetPhaseShift(const unsigned& WhichMomBin, const unsigned short& us
 
 float CATS::EvalPhaseShift(const double& Momentum, const unsigned short& usCh, const unsigned short& usPW) const{
     if(Momentum<MomBin[0] || Momentum>MomBin[NumMomBins] || NumCh<=usCh || NumPW[usCh]<=usPW) return 0;
-    return EvalBinnedFun(Momentum, NumMomBins, MomBin, MomBinCenter, PhaseShiftF[usCh][usPW]);
+    return EvalBinnedFun(Momentum, GetMomBin(Momentum), NumMomBins, MomBin, MomBinCenter, PhaseShiftF[usCh][usPW]);
     //return EvalBinnedFun(Momentum, NumMomBins, MomBin, NULL, PhaseShiftF[usCh][usPW]);
 }
 
 unsigned CATS::GetNumRadialWFpts(const unsigned& WhichMomBin, const unsigned short& usCh, const unsigned short& usPW) const{
-    return SavedWaveFunBins[WhichMomBin][usCh][usPW];
+    return SavedWaveFunBins[WfIndex(WhichMomBin,usCh,usPW)];
 }
 
 complex<double> CATS::GetRadialWaveFunction(const unsigned& WhichMomBin, const unsigned short& usCh, const unsigned short& usPW, const unsigned& WhichRadBin) const{
-    if(NumMomBins<=WhichMomBin || NumCh<=usCh || NumPW[usCh]<=usPW || SavedWaveFunBins[WhichMomBin][usCh][usPW]<=WhichRadBin) return 0;
-    return WaveFunctionU[WhichMomBin][usCh][usPW][WhichRadBin];
+    if(NumMomBins<=WhichMomBin || NumCh<=usCh || NumPW[usCh]<=usPW) return 0;
+    const unsigned uWf = WfIndex(WhichMomBin,usCh,usPW);
+    if(SavedWaveFunBins[uWf]<=WhichRadBin) return 0;
+    return WaveFunctionU[uWf][WhichRadBin];
 }
 
 complex<double> CATS::EvalRadialWaveFunction(const unsigned& WhichMomBin, const unsigned short& usCh, const unsigned short& usPW, const double& Radius,
@@ -1339,6 +1589,7 @@ void CATS::RemoveShortRangePotential(){
     for(unsigned short usCh=0; usCh<NumCh; usCh++){
         for(unsigned short usPW=0; usPW<NumPW[usCh]; usPW++){
             ShortRangePotential[usCh][usPW] = 0;
+            ShortRangePotentialBatch[usCh][usPW] = NULL;
             PotPar[usCh][usPW] = NULL;
             //PotParArray[usCh][usPW] = NULL;
         }
@@ -1361,10 +1612,11 @@ void CATS::RemoveShortRangePotential(const unsigned& usCh, const unsigned& usPW)
     if(!ShortRangePotential) return;
     if(!ShortRangePotential[usCh]) return;
     ShortRangePotential[usCh][usPW] = 0;
+    ShortRangePotentialBatch[usCh][usPW] = NULL;
     if(PotPar[usCh][usPW]) delete PotPar[usCh][usPW];
     PotPar[usCh][usPW] = NULL;
     //PotParArray[usCh][usPW] = NULL;
-    ComputedWaveFunction = false;
+    SetPwChanged(usCh,usPW);
     ComputedCorrFunction = false;
 }
 
@@ -1384,15 +1636,36 @@ void CATS::SetShortRangePotential(const unsigned& usCh, const unsigned& usPW, do
     }
 
     ShortRangePotential[usCh][usPW] = pot;
+    ShortRangePotentialBatch[usCh][usPW] = NULL;
     if(PotPar[usCh][usPW]){
         delete PotPar[usCh][usPW];
     }
     PotPar[usCh][usPW] = new CATSparameters(Pars);
     //PotParArray[usCh][usPW] = NULL;
 
-    ComputedWaveFunction = false;
+    SetPwChanged(usCh,usPW);
     ComputedCorrFunction = false;
 }
+
+//the batch potential is assumed to give the same result as the scalar one, thus the wave functions remain valid
+void CATS::SetShortRangePotentialBatch(const unsigned& usCh, const unsigned& usPW, CatsPotentialBatch potbatch){
+    if(usCh>=NumCh){
+        if(Notifications>=nError)
+            printf("\033[1;31mERROR:\033[0m Bad input in CATS::SetShortRangePotentialBatch(...)\n");
+        return;
+    }
+    if(usPW>=NumPW[usCh]){
+        if(Notifications>=nError)
+            printf("\033[1;31mERROR:\033[0m Bad input in CATS::SetShortRangePotentialBatch(...)\n");
+        return;
+    }
+    if(potbatch && !ShortRangePotential[usCh][usPW]){
+        if(Notifications>=nWarning)
+            printf("\033[1;33mWARNING:\033[0m SetShortRangePotentialBatch is called before setting the potential of usCh=%u, usPW=%u\n",usCh,usPW);
+        return;
+    }
+    ShortRangePotentialBatch[usCh][usPW] = potbatch;
+}
 /*
 void CATS::SetShortRangePotential(const unsigned& usCh, const unsigned& usPW, double (*pot)(double* Pars), double* Pars){
     if(usCh>=NumCh){
@@ -1435,7 +1708,7 @@ void CATS::SetShortRangePotential(const unsigned& usCh, const unsigned& usPW, co
     if(PotPar[usCh][usPW]) PotPar[usCh][usPW]->SetParameter(WhichPar,Value,false);
     //else if(PotParArray[usCh][usPW]) PotParArray[usCh][usPW][WhichPar+NumPotPars]=Value;
 
-    ComputedWaveFunction = false;
+    SetPwChanged(usCh,usPW,true);
     ComputedCorrFunction = false;
 
 }
@@ -1444,8 +1717,9 @@ void CATS::RemoveAnaSource(){
     //if(!AnaSourcePar && !AnaSourceParArray) return;
     if(!AnaSourcePar) return;
     AnalyticSource = NULL;
+    AnalyticSourceBatch = NULL;
     ForwardedSource = NULL;
-    SourceGridReady = false;
+    SourceFunChanged = true;
     SourceUpdated = false;
     ComputedCorrFunction = false;
 }
@@ -1456,6 +1730,7 @@ void CATS::SetAnaSource(double (*AS)(double*), CATSparameters& Pars){
     //    return;
     //}
     AnalyticSource = AS;
+    AnalyticSourceBatch = NULL;
     ForwardedSource = NULL;
     if(AnaSourcePar){
         delete AnaSourcePar;
@@ -1463,7 +1738,7 @@ void CATS::SetAnaSource(double (*AS)(double*), CATSparameters& Pars){
     AnaSourcePar = new CATSparameters(Pars);
 
     //AnaSourceParArray = NULL;
-    SourceGridReady = false;
+    SourceFunChanged = true;
     SourceUpdated = false;
     ComputedCorrFunction = false;
 }
@@ -1497,16 +1772,42 @@ void CATS::SetAnaSource(double (*FS)(void*, double*), void* context, const unsig
         return;
     }
     AnalyticSource = NULL;
+    AnalyticSourceBatch = NULL;
     ForwardedSource = FS;
     //AnaSourcePar = ForwardedSourcePar;
 //printf("AnaSourcePar = ForwardedSourcePar\n");
 //printf(" npar=%u\n",AnaSourcePar->GetNumPars());
 //usleep(1e6);
     SourceContext = context;
-    SourceGridReady = false;
+    SourceFunChanged = true;
     SourceUpdated = false;
     ComputedCorrFunction = false;
 }
+void CATS::SetThreadSafeSource(const bool& threadsafe){
+    if(ThreadSafeSource==threadsafe) return;
+    ThreadSafeSource = threadsafe;
+    //the grid keeps the number of threads used for the source
+    SourceFunChanged = true;
+    SourceUpdated = false;
+}
+bool CATS::GetThreadSafeSource() const{
+    return ThreadSafeSource;
+}
+void* CATS::GetSourceContext() const{
+    return ForwardedSource?SourceContext:NULL;
+}
+unsigned short CATS::SourceTeamSize(const unsigned short& NumThreads) const{
+    return (ForwardedSource&&!ThreadSafeSource)?1:NumThreads;
+}
+//as for the potential, the batch source should not change the result, thus the source grid remains valid
+void CATS::SetAnaSourceBatch(CatsSourceBatch ASB){
+    if(ASB && !AnalyticSource){
+        if(Notifications>=nWarning)
+            printf("\033[1;33mWARNING:\033[0m SetAnaSourceBatch is called without an analytic source function!\n");
+        return;
+    }
+    AnalyticSourceBatch = ASB;
+}
 /*
 void CATS::SetAnaSource(const CatsSource& SOURCE){
     if(&SOURCE==MemberSource) return;
@@ -1544,7 +1845,7 @@ void CATS::SetAnaSource(const unsigned& WhichPar, const double& Value, const boo
     //}
 
     if(UseAnalyticSource){
-        SourceGridReady = SourceGridReady?SmallChange:false;
+        if(!SmallChange) SourceFunChanged = true;
         SourceUpdated = false;
         ComputedCorrFunction = false;
     }
@@ -1579,7 +1880,7 @@ void CATS::SetExternalWaveFunction(const unsigned& usCh, const unsigned& usPW, D
             printf("\033[1;31mERROR:\033[0m Bad input in CATS::SetExternalWaveFunction(...)\n");
         return;
     }
-    ComputedWaveFunction = false;
+    SetPwChanged(usCh,usPW);
     ComputedCorrFunction = false;
     if(!ExternalWF[usCh][usPW]){ExternalWF[usCh][usPW] = new DLM_Histo<complex<double>> ();}
     *ExternalWF[usCh][usPW] = histWF;
@@ -1605,7 +1906,7 @@ void CATS::RemoveExternalWaveFunction(const unsigned& usCh, const unsigned& usPW
             printf("\033[1;31mERROR:\033[0m Bad input in CATS::RemoveExternalWaveFunction(...)\n");
         return;
     }
-    ComputedWaveFunction = false;
+    SetPwChanged(usCh,usPW);
     ComputedCorrFunction = false;
     if(ExternalWF&&ExternalWF[usCh]&&ExternalWF[usCh][usPW])
         {delete ExternalWF[usCh][usPW]; ExternalWF[usCh][usPW]= NULL;}
@@ -1661,7 +1962,7 @@ void CATS::KillTheCat(const int& Options){
     switch(Options){
     case kSourceChanged:
         LoadedData *= UseAnalyticSource;
-        SourceGridReady = false;
+        SourceFunChanged = true;
         SourceUpdated = false;
         ComputedCorrFunction = false;
         break;
@@ -1679,7 +1980,16 @@ void CATS::KillTheCat(const int& Options){
     default: break;
     }
 
-    bool TotWaveFunEvaluated = SourceGridReady*ComputedWaveFunction;
+    //the fixed source grid does not depend on the source, thus it (and the total wave function) is kept if only the source has changed.
+    //Any other change (momentum bins, MaxRad, grid settings etc.) resets SourceGridReady directly
+    if(SourceFunChanged){
+        if(!FixedSourceGridReady()) SourceGridReady = false;
+        SourceUpdated = false;
+        SourceFunChanged = false;
+    }
+
+    const bool WaveFunReady = WaveFunctionUpToDate();
+    bool TotWaveFunEvaluated = SourceGridReady*WaveFunReady;
     //if the poor man renormalization is used, the wave function needs to be reevaluated each time
     if(PoorManRenorm!=0 && UseAnalyticSource==false) TotWaveFunEvaluated*=ComputedCorrFunction;
     bool ReallocateTotWaveFun = !SourceGridReady;
@@ -1737,9 +2047,19 @@ void CATS::KillTheCat(const int& Options){
     if(Notifications>=nAll)
         printf("          \033[1;32mDone!\033[0m\n");
 
+    //the stages 3-5 are done together, as the choice of the momentum bins to be solved depends on the correlation function
+    if(AdaptiveMomBins>0 && (!WaveFunReady || !TotWaveFunEvaluated || !ComputedCorrFunction)){
+        if(Notifications>=nAll)
+            printf("\033[1;37m Stage 3-5:\033[0m Adaptive evaluation of the momentum bins...\n");
+        ComputeAdaptiveMomBins(TotWaveFunEvaluated, ReallocateTotWaveFun);
+        if(Notifications>=nAll)
+            printf("          \033[1;32mDone!\033[0m\n\n");
+        return;
+    }
+
     if(Notifications>=nAll)
         printf("\033[1;37m Stage 3:\033[0m Solving the Schroedinger equation...\n");
-    if(!ComputedWaveFunction) ComputeWaveFunction();
+    if(!WaveFunReady) ComputeWaveFunction();
     if(Notifications>=nAll)
         printf("          \033[1;32mDone!\033[0m\n");
 
@@ -1764,7 +2084,33 @@ bool CATS::SourceStatus(){
     return SourceUpdated;
 }
 bool CATS::PotentialStatus(){
-    return ComputedWaveFunction;
+    return WaveFunctionUpToDate();
+}
+
+bool CATS::WaveFunctionUpToDate() const{
+    if(!ComputedWaveFunction) return false;
+    for(unsigned uChPw=0; uChPw<NumChPw; uChPw++){
+        if(PwChanged[uChPw]) return false;
+    }
+    return true;
+}
+
+void CATS::SetPwChanged(const unsigned& usCh, const unsigned& usPW, const bool& OnlyPars){
+    if(!PwChanged || usPW>=NumPW[usCh]) {ComputedWaveFunction = false; return;}
+    unsigned char& Changed = PwChanged[ChPwOffset[usCh]+usPW];
+    //replacing the potential can change the number of reference PWs summed up in EffectiveFunction, so this needs a full update
+    if(!OnlyPars) Changed = 2;
+    else if(!Changed) Changed = 1;
+}
+
+void CATS::InvalidateWaveFunction(const unsigned& uMomBin, const unsigned short& usCh, const unsigned short& usPW, const bool& FullUpdate){
+    const unsigned uWf = WfIndex(uMomBin,usCh,usPW);
+    WaveFunValid[uWf] = false;
+    PwTermValid[uWf] = false;
+    if(!WaveFun2Status) return;
+    unsigned char& Status = WaveFun2Status[uMomBin*NumCh+usCh];
+    if(FullUpdate) Status = 0;
+    else if(Status>1) Status = 1;
 }
 
 void CATS::ComputeTheRadialWaveFunction(){
@@ -1776,11 +2122,50 @@ void CATS::ComputeWaveFunction(){
 
     if(!MomBinConverged){
         MomBinConverged = new bool [NumMomBins];
+        for(unsigned uMomBin=0; uMomBin<NumMomBins; uMomBin++){
+            MomBinConverged[uMomBin] = true;
+        }
+    }
+    //only the solutions which are not valid are computed. Those are all of them if a global setting has changed,
+    //the changed PWs (in all momentum bins) and all PWs of the momentum bins which have previously failed.
+    //after a global change WaveFunction2 is fully reevaluated, including the channels without any PWs
+    if(!ComputedWaveFunction && WaveFun2Status){
+        for(unsigned uMomCh=0; uMomCh<NumMomBins*NumCh; uMomCh++) WaveFun2Status[uMomCh] = 0;
+    }
+    for(unsigned uMomBin=0; uMomBin<NumMomBins; uMomBin++){
+        for(unsigned short usCh=0; usCh<NumCh; usCh++){
+            for(unsigned short usPW=0; usPW<NumPW[usCh]; usPW++){
+                const unsigned char& Changed = PwChanged[ChPwOffset[usCh]+usPW];
+                if(!ComputedWaveFunction || Changed) InvalidateWaveFunction(uMomBin,usCh,usPW,!ComputedWaveFunction||Changed>1);
+            }
+        }
     }
+    if(PotTableStatus){
+        for(unsigned uChPw=0; uChPw<NumChPw; uChPw++){
+            if(!ComputedWaveFunction || PwChanged[uChPw]) PotTableStatus[uChPw] = 0;
+        }
+    }
+    for(unsigned uChPw=0; uChPw<NumChPw; uChPw++) PwChanged[uChPw] = 0;
+
     for(unsigned uMomBin=0; uMomBin<NumMomBins; uMomBin++){
+        if(MomBinSelected && !MomBinSelected[uMomBin]) continue;
+        if(MomBinConverged[uMomBin]) continue;
+        for(unsigned short usCh=0; usCh<NumCh; usCh++){
+            for(unsigned short usPW=0; usPW<NumPW[usCh]; usPW++) InvalidateWaveFunction(uMomBin,usCh,usPW,true);
+        }
         MomBinConverged[uMomBin] = true;
     }
 
+    //the cache is used only if all momentum bins are computed
+    if(WaveFunctionCache && !MomBinSelected && LoadWaveFunctionCache()){
+        for(unsigned uWf=0; uWf<NumMomBins*NumChPw; uWf++) {WaveFunValid[uWf] = true; PwTermValid[uWf] = false;}
+        if(WaveFun2Status){
+            for(unsigned uMomCh=0; uMomCh<NumMomBins*NumCh; uMomCh++) WaveFun2Status[uMomCh] = 0;
+        }
+        ComputedWaveFunction = true;
+        return;
+    }
+
     //here one finds the max num PWs, this is needed later on for
     //the correct mapping of all variables
     unsigned short MaxNumPW=0;
@@ -1792,11 +2177,13 @@ void CATS::ComputeWaveFunction(){
         }
         for(unsigned short usPW=0; usPW<NumPW[usCh]; usPW++){
             if(!ShortRangePotential[usCh][usPW] && !ExternalWF[usCh][usPW]) continue;
-            TotNumSteps++;
+            for(unsigned uMomBin=0; uMomBin<NumMomBins; uMomBin++){
+                if(MomBinSelected && !MomBinSelected[uMomBin]) continue;
+                if(!WaveFunValid[WfIndex(uMomBin,usCh,usPW)]) TotNumSteps++;
+            }
         }
     }
     unsigned TotalNumberOfBins = NumMomBins*NumCh*MaxNumPW;
-    TotNumSteps *= NumMomBins;
 
     unsigned uMomBin;
     unsigned short usCh;
@@ -1814,8 +2201,14 @@ void CATS::ComputeWaveFunction(){
     //the problem with the omp is that the same PotPar are used, we need separate instance for each thread if we want it to work
     //this is however difficult as currently I only pass a single pointer as PotPar, and I do not know how many arguments there are
     //the same problem should occur for the source
-    unsigned short NumThreads = omp_get_num_procs();
-    if(NumThreads>MaxNumThreads) NumThreads = MaxNumThreads;
+    unsigned short NumThreads = Execution->GetTeamSize();
+    //each thread needs its own parameters of the potentials
+    for(unsigned short usCh=0; usCh<NumCh; usCh++){
+        for(unsigned short usPW=0; usPW<NumPW[usCh]; usPW++){
+            if(PotPar[usCh][usPW]) PotPar[usCh][usPW]->SetNumThreads(NumThreads);
+        }
+    }
+    if(PotTableNumRad) TabulatePotentials(NumThreads);
     #pragma omp parallel for private(uMomBin,usCh,usPW) num_threads(NumThreads)
     for(unsigned uMPP=0; uMPP<TotalNumberOfBins; uMPP++){
         //compute to which MomBin, Polarization and PW corresponds this MPP,
@@ -1823,15 +2216,20 @@ void CATS::ComputeWaveFunction(){
         uMomBin = uMPP/(NumCh*MaxNumPW);
         usCh = (uMPP%(NumCh*MaxNumPW))/(MaxNumPW);
         usPW = (uMPP%(NumCh*MaxNumPW))%(MaxNumPW);
+        if(MomBinSelected && !MomBinSelected[uMomBin]) continue;
         //since uMPP is build under the assumption all NumPW are the same
         //one has to check if usPW has a meaningful value!
         if(usPW>=NumPW[usCh]) continue;
+        const unsigned uWf = WfIndex(uMomBin,usCh,usPW);
+        //the solution is still up to date
+        if(WaveFunValid[uWf]) continue;
         //if the potential for this channel and PW is zero => continue
         if(!ShortRangePotential[usCh][usPW] && !ExternalWF[usCh][usPW]) continue;
         //skip momentum bins which have obtained an error code
         if(!MomBinConverged[uMomBin] && ExcludeFailedConvergence) continue;
 
-        SavedWaveFunBins[uMomBin][usCh][usPW]=0;
+        WaveFunValid[uWf]=true;
+        SavedWaveFunBins[uWf]=0;
 
         //if s+l is odd, than this partial wave will cancel out during the
         //symmetrization for identical particles
@@ -1846,6 +2244,8 @@ void CATS::ComputeWaveFunction(){
         if(!ExternalWF[usCh][usPW]){
             double* BufferWaveFunction;
             double* BufferRad;
+            //the parameters of the potential for this thread, obtained only once for the whole solution
+            double* PotParameters = PotPar[usCh][usPW]?PotPar[usCh][usPW]->GetParameters(omp_get_thread_num()):NULL;
 
             int q1q2 = Gamow?0:Q1Q2;
             unsigned NumComputedPoints = 2;//counting the initial two starting points
@@ -1869,7 +2269,7 @@ void CATS::ComputeWaveFunction(){
             double MaxDeltaRad;
             double MinDeltaRad;
 
-            PropagatingFunction(PropFunWithoutSI[0], PropFunVal[0], StartRad, Momentum, usPW, usCh);
+            PropagatingFunction(PropFunWithoutSI[0], PropFunVal[0], StartRad, Momentum, usPW, usCh, PotParameters);
             MinDeltaRad = sqrt(fabs(EpsilonProp/(PropFunVal[0]+1e-64)));
             MaxDeltaRad = sqrt(EpsilonProp/(Momentum*Momentum));
 
@@ -1890,13 +2290,13 @@ void CATS::ComputeWaveFunction(){
             Rho[kOld] = Momentum*PosRad[kOld];
             DeltaRad[kOld] = MinDeltaRad;
             DeltaRad2[kOld] = DeltaRad[kOld]*DeltaRad[kOld];
-            PropagatingFunction(PropFunWithoutSI[kOld], PropFunVal[kOld], PosRad[kOld], Momentum, usPW, usCh);
+            PropagatingFunction(PropFunWithoutSI[kOld], PropFunVal[kOld], PosRad[kOld], Momentum, usPW, usCh, PotParameters);
 
             PosRad[kCurrent] = PosRad[kOld]+DeltaRad[kOld];
             Rho[kCurrent] = Momentum*PosRad[kCurrent];
             DeltaRad[kCurrent] = MinDeltaRad;
             DeltaRad2[kCurrent] = DeltaRad[kCurrent]*DeltaRad[kCurrent];
-            PropagatingFunction(PropFunWithoutSI[kCurrent], PropFunVal[kCurrent], PosRad[kCurrent], Momentum, usPW, usCh);
+            PropagatingFunction(PropFunWithoutSI[kCurrent], PropFunVal[kCurrent], PosRad[kCurrent], Momentum, usPW, usCh, PotParameters);
 
             //the initial values for the wave function are set based on the solution without the strong potential.
             //this will of course lead to a wrong normalization in the asymptotic region, but this will be corrected for later on,
@@ -1981,17 +2381,7 @@ void CATS::ComputeWaveFunction(){
                 }
 
                 BufferWaveFunction[NumComputedPoints] = WaveFun[kNew];
-if(NumComputedPoints<32 && NumComputedPoints%1==0 && uMomBin==0 && uMPP==0 && false){
-printf("Momentum=%f\n",Momentum);
-DEBUG=omp_get_thread_num();
-}
-else{
-    #pragma omp critical
-    {
-    DEBUG=-1;
-    }
-}
-                PropagatingFunction(PropFunWithoutSI[kNew], PropFunVal[kNew], PosRad[kNew], Momentum, usPW, usCh);
+                PropagatingFunction(PropFunWithoutSI[kNew], PropFunVal[kNew], PosRad[kNew], Momentum, usPW, usCh, PotParameters);
 
                 DeltaRad2[kNew] = EpsilonProp/(fabs(PropFunVal[kNew])+1e-64);
                 DeltaRad[kNew] = sqrt(DeltaRad2[kNew]);
@@ -2005,13 +2395,15 @@ else{
                 }
 
                 BufferRad[NumComputedPoints] = PosRad[kNew];
-if(DEBUG==omp_get_thread_num()){
-printf("Stuff: \n");
-printf(" PropFunWithoutSI[%u]=%.15e\n",kNew,PropFunWithoutSI[kNew]);
-printf(" PropFunVal[%u]=%.15e\n",kNew,PropFunVal[kNew]);
-printf(" BufferRad[%u]=%.15e\n",NumComputedPoints,BufferRad[NumComputedPoints]);
-DEBUG=-1;
-}
+#ifdef CATS_DEBUG_PROPAGATION
+                //the trace is local to the thread working on the very first (k,ch,pw) bin, i.e. it needs no synchronization
+                if(uMPP==0 && NumComputedPoints<32){
+                    printf("Momentum=%f\n",Momentum);
+                    printf(" PropFunWithoutSI[%u]=%.15e\n",kNew,PropFunWithoutSI[kNew]);
+                    printf(" PropFunVal[%u]=%.15e\n",kNew,PropFunVal[kNew]);
+                    printf(" BufferRad[%u]=%.15e\n",NumComputedPoints,BufferRad[NumComputedPoints]);
+                }
+#endif
 
                 Convergence =   fabs( (PropFunWithoutSI[kOld]-PropFunVal[kOld])/(fabs(PropFunWithoutSI[kOld]+PropFunVal[kOld])+1e-64) ) < EpsilonConv &&
                                 fabs( (PropFunWithoutSI[kCurrent]-PropFunVal[kCurrent])/(fabs(PropFunWithoutSI[kCurrent]+PropFunVal[kCurrent])+1e-64) ) < EpsilonConv &&
@@ -2114,11 +2506,12 @@ DEBUG=-1;
 
                 //a potential solution should be locked in a region where the ShiftedReferenceWave*NumericalSol have the same sign.
                 //furthermore the ShiftedReferenceWave cannot possibly change sign in this region
+                //the step used to evaluate the asymptotic ratio. It is kept local, as a shared member would be overwritten by the other threads
+                const double RhoStep = DeltaRadAtMaxConv*Momentum;
                 for(unsigned uShift=0; uShift<MaximumShiftIter; uShift++){
                     //positive side
-                    CurrentRhoStep = DeltaRadAtMaxConv*Momentum;
-                    DownValue = AsymptoticRatio(MaxConvRad+DownShift, Momentum, usPW, q1q2) - NumRatio;
-                    UpValue = AsymptoticRatio(MaxConvRad+UpShift, Momentum, usPW, q1q2) - NumRatio;
+                    DownValue = AsymptoticRatio(MaxConvRad+DownShift, Momentum, usPW, q1q2, RhoStep) - NumRatio;
+                    UpValue = AsymptoticRatio(MaxConvRad+UpShift, Momentum, usPW, q1q2, RhoStep) - NumRatio;
 
                     if(DownValue*UpValue<0){
                         ShiftRad = 0.5*(DownShift+UpShift);
@@ -2129,8 +2522,8 @@ DEBUG=-1;
 
                     //negative side
                     if(UpShift<=MaxConvRad){
-                        DownValue = AsymptoticRatio(MaxConvRad-DownShift, Momentum, usPW, q1q2) - NumRatio;
-                        UpValue = AsymptoticRatio(MaxConvRad-UpShift, Momentum, usPW, q1q2) - NumRatio;
+                        DownValue = AsymptoticRatio(MaxConvRad-DownShift, Momentum, usPW, q1q2, RhoStep) - NumRatio;
+                        UpValue = AsymptoticRatio(MaxConvRad-UpShift, Momentum, usPW, q1q2, RhoStep) - NumRatio;
                         if(DownValue*UpValue<0){
                             ShiftRad = -0.5*(DownShift+UpShift);
                             SignProduct = ReferencePartialWave(MaxConvRad+ShiftRad, Momentum, usPW, q1q2)*MaxConvergedNumWF;
@@ -2151,7 +2544,7 @@ DEBUG=-1;
                 }
 
                 ShiftRad = NewtonRapson(&CATS::AsymptoticRatio,
-                        DeltaRadAtMaxConv, usPW, Momentum, q1q2, MaxConvRad+DownShift, MaxConvRad+UpShift, NumRatio,NR_Status) - MaxConvRad;
+                        DeltaRadAtMaxConv, usPW, Momentum, q1q2, RhoStep, MaxConvRad+DownShift, MaxConvRad+UpShift, NumRatio,NR_Status) - MaxConvRad;
                 //if(!NR_Status&&Notifications>=nWarning) {printf("The above warning triggered for bin nr. %u (k=%.2f)\n",uMomBin,GetMomentum(uMomBin));}
                 if(!NR_Status) {MomBinConverged[uMomBin]=false;}
 
@@ -2167,27 +2560,24 @@ DEBUG=-1;
                 //was not "perfect" there might be some inaccuracy in the interval up to the normalization point.
                 //btw. the step size is set to be the MaxDeltaRad
 
-                SavedWaveFunBins[uMomBin][usCh][usPW] = StepOfMaxConvergedNumWF+1;
-                unsigned& SWFB = SavedWaveFunBins[uMomBin][usCh][usPW];
-
-                if(WaveFunRad[uMomBin][usCh][usPW]) delete [] WaveFunRad[uMomBin][usCh][usPW];
-                WaveFunRad[uMomBin][usCh][usPW] = new double [SWFB+1];
-
-                if(WaveFunctionU[uMomBin][usCh][usPW]) delete [] WaveFunctionU[uMomBin][usCh][usPW];
-                WaveFunctionU[uMomBin][usCh][usPW] = new complex<double> [SWFB];
+                ReserveWaveFunction(uWf, StepOfMaxConvergedNumWF+1);
+                const unsigned& SWFB = SavedWaveFunBins[uWf];
+                complex<double>* WFU = WaveFunctionU[uWf];
+                double* WFR = WaveFunRad[uWf];
 
                 for(unsigned uPoint=0; uPoint<SWFB; uPoint++){
-                    WaveFunctionU[uMomBin][usCh][usPW][uPoint] = Norm*CPF[uMomBin]*BufferWaveFunction[uPoint];
+                    WFU[uPoint] = Norm*CPF[uMomBin]*BufferWaveFunction[uPoint];
                 }
 
                 //we set up those as bin-range (i.e. the middle of the bin should be buffer rad)
                 //we start from r=0, than proceed by adding the limit between different bins as the mid-way to the next point
-                WaveFunRad[uMomBin][usCh][usPW][0] = 0;
+                WFR[0] = 0;
                 for(unsigned uPoint=1; uPoint<SWFB; uPoint++){
-                    WaveFunRad[uMomBin][usCh][usPW][uPoint] = (BufferRad[uPoint]+BufferRad[uPoint-1])*0.5;
+                    WFR[uPoint] = (BufferRad[uPoint]+BufferRad[uPoint-1])*0.5;
                 }
                 //the very last point we simply set as the double distance between the last bin-limit and the last radius value
-                WaveFunRad[uMomBin][usCh][usPW][SWFB] = 2*BufferRad[SWFB-1]-WaveFunRad[uMomBin][usCh][usPW][SWFB-1];
+                WFR[SWFB] = 2*BufferRad[SWFB-1]-WFR[SWFB-1];
+                SetUniformRadBins(uWf);
 
             }//if(MomBinConverged[uMomBin] || !ExcludeFailedConvergence)
 
@@ -2215,25 +2605,20 @@ DEBUG=-1;
         }//end of the numerical computation
         //the case with external wave function
         else{
-            SavedWaveFunBins[uMomBin][usCh][usPW] = ExternalWF[usCh][usPW]->GetNbins(1);
-            unsigned& SWFB = SavedWaveFunBins[uMomBin][usCh][usPW];
-
-            if(WaveFunRad[uMomBin][usCh][usPW]) delete [] WaveFunRad[uMomBin][usCh][usPW];
-            WaveFunRad[uMomBin][usCh][usPW] = new double [SWFB+1];
-
-            if(WaveFunctionU[uMomBin][usCh][usPW]) delete [] WaveFunctionU[uMomBin][usCh][usPW];
-            WaveFunctionU[uMomBin][usCh][usPW] = new complex<double> [SWFB];
+            ReserveWaveFunction(uWf, ExternalWF[usCh][usPW]->GetNbins(1));
+            const unsigned& SWFB = SavedWaveFunBins[uWf];
 
             for(unsigned uPoint=0; uPoint<=SWFB; uPoint++){
                 //the input from outside is supposed to be in fermi, hence to conversion
-                WaveFunRad[uMomBin][usCh][usPW][uPoint] = ExternalWF[usCh][usPW]->GetBinLowEdge(1,uPoint)*FmToNu;
+                WaveFunRad[uWf][uPoint] = ExternalWF[usCh][usPW]->GetBinLowEdge(1,uPoint)*FmToNu;
             }
+            SetUniformRadBins(uWf);
 
             double EvalPoint[2];
             EvalPoint[0] = GetMomentum(uMomBin);
             for(unsigned uPoint=0; uPoint<SWFB; uPoint++){
                 EvalPoint[1] = ExternalWF[usCh][usPW]->GetBinCenter(1,uPoint);
-                WaveFunctionU[uMomBin][usCh][usPW][uPoint] = CPF[uMomBin]*ExternalWF[usCh][usPW]->Eval(EvalPoint)*FmToNu;
+                WaveFunctionU[uWf][uPoint] = CPF[uMomBin]*ExternalWF[usCh][usPW]->Eval(EvalPoint)*FmToNu;
 
             }
         }
@@ -2255,34 +2640,313 @@ DEBUG=-1;
         }
 
     }//for(unsigned uMPP=0; uMPP<TotalNumberOfBins; uMPP++)
+
+    //the failed momentum bins are fully recomputed the next time
+    for(unsigned uMomBin=0; uMomBin<NumMomBins; uMomBin++){
+        if(MomBinConverged[uMomBin]) continue;
+        for(unsigned short usCh=0; usCh<NumCh; usCh++){
+            for(unsigned short usPW=0; usPW<NumPW[usCh]; usPW++) InvalidateWaveFunction(uMomBin,usCh,usPW,true);
+        }
+    }
     ComputedWaveFunction = true;
     if(Notifications>=nAll) printf("\r\033[K");
     delete [] cdummy;
+
+    if(WaveFunctionCache && !MomBinSelected) SaveWaveFunctionCache();
 }
 
-void CATS::ComputeTotWaveFunction(const bool& ReallocateTotWaveFun){
-    if(!BaseSourceGrid) return;
+void CATS::TabulatePotentials(const unsigned short& NumThreads){
+    if(!PotTable){
+        PotTable = new double* [NumChPw];
+        PotTableStatus = new unsigned char [NumChPw];
+        for(unsigned uChPw=0; uChPw<NumChPw; uChPw++){
+            PotTable[uChPw] = NULL;
+            PotTableStatus[uChPw] = 0;
+        }
+    }
+    const unsigned& NumRad = PotTableNumRad;
+    //a change of MaxRad is a global change, i.e. all tables are recomputed in that case
+    PotTableStep = MaxRad*NuToFm/double(NumRad);
+    #pragma omp parallel for schedule(dynamic) num_threads(NumThreads)
+    for(unsigned uChPw=0; uChPw<NumChPw; uChPw++){
+        if(PotTableStatus[uChPw]) continue;
+        unsigned short usCh=0;
+        while(usCh+1<NumCh && ChPwOffset[usCh+1]<=uChPw) usCh++;
+        const unsigned short usPW = uChPw-ChPwOffset[usCh];
+        if(PotTable[uChPw]) {delete [] PotTable[uChPw]; PotTable[uChPw]=NULL;}
+        PotTableStatus[uChPw] = 1;
+        if(!ShortRangePotential[usCh][usPW] || ExternalWF[usCh][usPW]) continue;
+
+        //the tabulated radii followed by the mid-points in between, used to check the accuracy
+        double* Rad = new double [2*NumRad];
+        double* Pot = new double [2*NumRad];
+        for(unsigned uRad=0; uRad<NumRad; uRad++){
+            Rad[uRad] = PotTableStep*double(uRad+1);
+            Rad[NumRad+uRad] = PotTableStep*(double(uRad)+1.5);
+        }
+        EvaluateThePotential(usCh,usPW,GetMomentum(0),NumRad,Rad,Pot);
+        EvaluateThePotential(usCh,usPW,GetMomentum(NumMomBins-1),NumRad-1,&Rad[NumRad],&Pot[NumRad]);
+
+        //the second derivatives S (times Step^2/6) follow from S[uRad-1]+4*S[uRad]+S[uRad+1] = Pot[uRad-1]-2*Pot[uRad]+Pot[uRad+1],
+        //the ones at the end points are approximated with (one-sided) finite differences. Solved with the Thomas algorithm.
+        double* Table = new double [2*NumRad];
+        double* Cp = new double [NumRad];
+        double* Dp = new double [NumRad];
+        for(unsigned uRad=0; uRad<NumRad; uRad++) Table[2*uRad] = Pot[uRad];
+        Table[1] = (2.*Pot[0]-5.*Pot[1]+4.*Pot[2]-Pot[3])/6.;
+        Table[2*NumRad-1] = (2.*Pot[NumRad-1]-5.*Pot[NumRad-2]+4.*Pot[NumRad-3]-Pot[NumRad-4])/6.;
+        for(unsigned uRad=1; uRad<NumRad-1; uRad++){
+            double Rhs = Pot[uRad-1]-2.*Pot[uRad]+Pot[uRad+1];
+            if(uRad==1) Rhs -= Table[1];
+            if(uRad==NumRad-2) Rhs -= Table[2*NumRad-1];
+            const double Diag = uRad==1?4.:4.-Cp[uRad-1];
+            Cp[uRad] = 1./Diag;
+            Dp[uRad] = uRad==1?Rhs/Diag:(Rhs-Dp[uRad-1])/Diag;
+        }
+        Table[2*(NumRad-2)+1] = Dp[NumRad-2];
+        for(unsigned uRad=NumRad-3; uRad>=1; uRad--){
+            Table[2*uRad+1] = Dp[uRad]-Cp[uRad]*Table[2*uRad+3];
+        }
+        delete [] Cp;
+        delete [] Dp;
+
+        double MaxPot=0;
+        double MaxDev=0;
+        for(unsigned uRad=0; uRad<NumRad; uRad++){
+            if(fabs(Pot[uRad])>MaxPot) MaxPot = fabs(Pot[uRad]);
+        }
+        for(unsigned uRad=0; uRad<NumRad-1; uRad++){
+            //at the mid-point the spline is 0.5*(V1+V2)-0.375*(S1+S2)
+            const double Dev = fabs(0.5*(Table[2*uRad]+Table[2*uRad+2])-0.375*(Table[2*uRad+1]+Table[2*uRad+3])-Pot[NumRad+uRad]);
+            //the negation catches a nan
+            if(!(Dev<=MaxDev)) MaxDev = Dev;
+        }
+        delete [] Rad;
+        delete [] Pot;
+        if(MaxDev<=PotTableTolerance*MaxPot){
+            PotTable[uChPw] = Table;
+        }
+        else{
+            delete [] Table;
+            PotTableStatus[uChPw] = 2;
+            if(Notifications>=nWarning)
+                printf("\033[1;33mWARNING:\033[0m The tabulated potential of usCh=%u, usPW=%u deviates by %.2e MeV (max |V|=%.2e MeV), it will be evaluated directly\n",
+                       usCh,usPW,MaxDev,MaxPot);
+        }
+    }
+}
+
+unsigned CATS::WaveFunctionCacheKey(double* Key){
+    unsigned KeyLength=0;
+    //saves the value only if Key is defined, but always counts the length of the key
+    auto AddToKey = [&Key,&KeyLength](const double& value){if(Key) Key[KeyLength]=value; KeyLength++;};
+    AddToKey(RedMass);
+    AddToKey(Q1Q2);
+    AddToKey(Gamow);
+    AddToKey(IdenticalParticles);
+    AddToKey(StartRad);
+    AddToKey(EpsilonProp);
+    AddToKey(EpsilonConv);
+    AddToKey(MaxRad);
+    AddToKey(MaxRho);
+    AddToKey(ExcludeFailedConvergence);
+    AddToKey(WaveFunctionCacheId);
+    //the tabulated potentials change the solution (slightly)
+    if(PotTableNumRad){
+        AddToKey(PotTableNumRad);
+        AddToKey(PotTableTolerance);
+    }
+    AddToKey(NumMomBins);
+    for(unsigned uMomBin=0; uMomBin<NumMomBins; uMomBin++){
+        AddToKey(MomBin[uMomBin]);
+        AddToKey(GetMomentum(uMomBin));
+    }
+    AddToKey(MomBin[NumMomBins]);
+    AddToKey(NumCh);
+    //the potentials are evaluated at several radii (in fm) and momenta
+    const unsigned NumFingerRad = 32;
+    const double MinFingerRad = 0.01;
+    const double MaxFingerRad = MaxRad*NuToFm>MinFingerRad?MaxRad*NuToFm:1;
+    const unsigned NumFingerMom = NumMomBins>1?3:1;
+    double FingerRad[NumFingerRad];
+    double FingerPot[NumFingerRad];
+    for(unsigned uRad=0; uRad<NumFingerRad; uRad++){
+        FingerRad[uRad] = MinFingerRad*pow(MaxFingerRad/MinFingerRad,double(uRad)/double(NumFingerRad-1));
+    }
+    for(unsigned short usCh=0; usCh<NumCh; usCh++){
+        AddToKey(NumPW[usCh]);
+        AddToKey(Spin[usCh]);
+        for(unsigned short usPW=0; usPW<NumPW[usCh]; usPW++){
+            AddToKey(ShortRangePotential[usCh][usPW]!=NULL);
+            if(!ShortRangePotential[usCh][usPW]) continue;
+            //a potential without parameters is fingerprinted only by its values
+            const unsigned NumPotPars = PotPar[usCh][usPW]?PotPar[usCh][usPW]->GetNumPars():0;
+            AddToKey(NumPotPars);
+            for(unsigned uPar=0; uPar<NumPotPars; uPar++){
+                AddToKey(PotPar[usCh][usPW]->GetParameter(uPar));
+            }
+            for(unsigned uMom=0; uMom<NumFingerMom; uMom++){
+                EvaluateThePotential(usCh,usPW,GetMomentum(uMom*(NumMomBins-1)/2),NumFingerRad,FingerRad,FingerPot);
+                for(unsigned uRad=0; uRad<NumFingerRad; uRad++){
+                    AddToKey(FingerPot[uRad]);
+                }
+            }
+        }
+    }
+    return KeyLength;
+}
+
+void CATS::WaveFunctionCacheFile(const double* Key, const unsigned& KeyLength, char* FileName) const{
+    //FNV-1a hash of the key
+    uint64_t Hash = 14695981039346656037ULL;
+    const unsigned char* KeyByte = (const unsigned char*)Key;
+    for(unsigned uByte=0; uByte<KeyLength*sizeof(double); uByte++){
+        Hash ^= KeyByte[uByte];
+        Hash *= 1099511628211ULL;
+    }
+    sprintf(FileName, "%s/CATS_WF_%016llx.bin", WaveFunctionCache, (unsigned long long)Hash);
+}
+
+static const char CatsWfCacheMagic[8] = {'C','A','T','S','w','f','c','\0'};
+
+bool CATS::LoadWaveFunctionCache(){
+    for(unsigned short usCh=0; usCh<NumCh; usCh++){
+        for(unsigned short usPW=0; usPW<NumPW[usCh]; usPW++){
+            //the external wave functions are not cached
+            if(ExternalWF[usCh][usPW]) return false;
+        }
+    }
+    const unsigned KeyLength = WaveFunctionCacheKey(NULL);
+    double* Key = new double [KeyLength];
+    WaveFunctionCacheKey(Key);
+    char* FileName = new char [strlen(WaveFunctionCache)+64];
+    WaveFunctionCacheFile(Key, KeyLength, FileName);
+
+    FILE* InFile = fopen(FileName, "rb");
+    delete [] FileName;
+    if(!InFile){
+        delete [] Key;
+        return false;
+    }
+
+    char Magic[8];
+    unsigned FileKeyLength=0;
+    bool Status = fread(Magic,1,8,InFile)==8 && !memcmp(Magic,CatsWfCacheMagic,8) &&
+                  fread(&FileKeyLength,sizeof(unsigned),1,InFile)==1 && FileKeyLength==KeyLength;
+    if(Status){
+        //compare the full key, to exclude hash collisions
+        double* FileKey = new double [KeyLength];
+        Status = fread(FileKey,sizeof(double),KeyLength,InFile)==KeyLength && !memcmp(FileKey,Key,KeyLength*sizeof(double));
+        delete [] FileKey;
+    }
+    delete [] Key;
+
+    for(unsigned uMomBin=0; uMomBin<NumMomBins && Status; uMomBin++){
+        Status = fread(&MomBinConverged[uMomBin],sizeof(bool),1,InFile)==1;
+        for(unsigned short usCh=0; usCh<NumCh && Status; usCh++){
+            for(unsigned short usPW=0; usPW<NumPW[usCh] && Status; usPW++){
+                if(!ShortRangePotential[usCh][usPW]) continue;
+                const unsigned uWf = WfIndex(uMomBin,usCh,usPW);
+                unsigned SWFB;
+                Status = fread(&SWFB,sizeof(unsigned),1,InFile)==1 &&
+                         fread(&PhaseShift[uMomBin][usCh][usPW],sizeof(double),1,InFile)==1;
+                if(!Status) continue;
+                ReserveWaveFunction(uWf, SWFB);
+                if(!SWFB) continue;
+                PhaseShiftF[usCh][usPW][uMomBin] = PhaseShift[uMomBin][usCh][usPW];
+
+                Status = fread(WaveFunRad[uWf],sizeof(double),SWFB+1,InFile)==SWFB+1 &&
+                         fread(WaveFunctionU[uWf],sizeof(complex<double>),SWFB,InFile)==SWFB;
+                if(Status) SetUniformRadBins(uWf);
+            }
+        }
+    }
+    fclose(InFile);
 
-    if(WaveFunction2 && ReallocateTotWaveFun){
+    //in case of a corrupted file, everything is recomputed
+    if(!Status){
+        if(Notifications>=nWarning)
+            printf("\033[1;33mWARNING:\033[0m A corrupted file was found in the wave function cache, the result is recomputed!\n");
         for(unsigned uMomBin=0; uMomBin<NumMomBins; uMomBin++){
-            for(unsigned uGrid=0; uGrid<NumGridPts; uGrid++){
-                delete [] WaveFunction2[uMomBin][uGrid];
+            MomBinConverged[uMomBin] = true;
+        }
+    }
+    return Status;
+}
+
+void CATS::SaveWaveFunctionCache(){
+    for(unsigned short usCh=0; usCh<NumCh; usCh++){
+        for(unsigned short usPW=0; usPW<NumPW[usCh]; usPW++){
+            if(ExternalWF[usCh][usPW]) return;
+        }
+    }
+    const unsigned KeyLength = WaveFunctionCacheKey(NULL);
+    double* Key = new double [KeyLength];
+    WaveFunctionCacheKey(Key);
+    char* FileName = new char [strlen(WaveFunctionCache)+64];
+    WaveFunctionCacheFile(Key, KeyLength, FileName);
+    //the file is written under a temporary name and renamed at the end,
+    //so that other jobs sharing the same cache never read an incomplete file
+    char* TempName = new char [strlen(FileName)+32];
+    sprintf(TempName, "%s.%i", FileName, int(getpid()));
+
+    FILE* OutFile = fopen(TempName, "wb");
+    if(!OutFile){
+        if(Notifications>=nWarning)
+            printf("\033[1;33mWARNING:\033[0m The wave function cache file %s cannot be created!\n", TempName);
+        delete [] Key;
+        delete [] FileName;
+        delete [] TempName;
+        return;
+    }
+
+    bool Status = fwrite(CatsWfCacheMagic,1,8,OutFile)==8 &&
+                  fwrite(&KeyLength,sizeof(unsigned),1,OutFile)==1 &&
+                  fwrite(Key,sizeof(double),KeyLength,OutFile)==KeyLength;
+    for(unsigned uMomBin=0; uMomBin<NumMomBins && Status; uMomBin++){
+        Status = fwrite(&MomBinConverged[uMomBin],sizeof(bool),1,OutFile)==1;
+        for(unsigned short usCh=0; usCh<NumCh && Status; usCh++){
+            for(unsigned short usPW=0; usPW<NumPW[usCh] && Status; usPW++){
+                if(!ShortRangePotential[usCh][usPW]) continue;
+                const unsigned uWf = WfIndex(uMomBin,usCh,usPW);
+                const unsigned& SWFB = SavedWaveFunBins[uWf];
+                Status = fwrite(&SWFB,sizeof(unsigned),1,OutFile)==1 &&
+                         fwrite(&PhaseShift[uMomBin][usCh][usPW],sizeof(double),1,OutFile)==1;
+                if(!Status || !SWFB) continue;
+                Status = fwrite(WaveFunRad[uWf],sizeof(double),SWFB+1,OutFile)==SWFB+1 &&
+                         fwrite(WaveFunctionU[uWf],sizeof(complex<double>),SWFB,OutFile)==SWFB;
             }
-            delete [] WaveFunction2[uMomBin];
         }
-        delete [] WaveFunction2; WaveFunction2 = NULL;
     }
+    Status = !fclose(OutFile) && Status;
+
+    if(!Status || rename(TempName, FileName)){
+        remove(TempName);
+        if(Notifications>=nWarning)
+            printf("\033[1;33mWARNING:\033[0m The wave function cache file %s could not be written!\n", FileName);
+    }
+
+    delete [] Key;
+    delete [] FileName;
+    delete [] TempName;
+}
 
-    NumGridPts = BaseSourceGrid->GetNumEndNodes();
+void CATS::ComputeTotWaveFunction(const bool& ReallocateTotWaveFun){
+    const bool FixedGrid = UseFixedSourceGrid();
+    if(!BaseSourceGrid && !FixedGrid) return;
+
+    if(ReallocateTotWaveFun) DelMomCh();
+
+    NumGridPts = FixedGrid?NumFixedGridPts:BaseSourceGrid->GetNumGridPts();
 
     if(!WaveFunction2){
-        WaveFunction2 = new double** [NumMomBins];
+        WaveFunction2 = new double* [NumMomBins];
         for(unsigned uMomBin=0; uMomBin<NumMomBins; uMomBin++){
-            WaveFunction2[uMomBin] = new double* [NumGridPts];
-            for(unsigned uGrid=0; uGrid<NumGridPts; uGrid++){
-                WaveFunction2[uMomBin][uGrid] = new double [NumCh];
-            }
+            WaveFunction2[uMomBin] = new double [NumCh*NumGridPts];
         }
+        WaveFun2Status = new unsigned char [NumMomBins*NumCh];
+        WaveFun2NumIncr = new unsigned short [NumMomBins*NumCh];
+        for(unsigned uMomCh=0; uMomCh<NumMomBins*NumCh; uMomCh++) WaveFun2Status[uMomCh] = 0;
     }
 
     //double Momentum;
@@ -2294,27 +2958,80 @@ void CATS::ComputeTotWaveFunction(const bool& ReallocateTotWaveFun){
     int pTotalOld=0;
     double Progress;
     char* cdummy = new char [512];
-    double TotalSteps = double(NumMomBins)*double(NumGridPts);
+    unsigned NumSelectedMomBins=0;
+    for(unsigned uMomBin=0; uMomBin<NumMomBins; uMomBin++){
+        if(MomBinSelected && !MomBinSelected[uMomBin]) continue;
+        NumSelectedMomBins++;
+    }
+    double TotalSteps = double(NumSelectedMomBins)*double(NumGridPts);
     long long CurrentStep=0;
     DLM_Timer dlmTimer;
-    unsigned short NumThreads = omp_get_num_procs();
-    if(NumThreads>MaxNumThreads) NumThreads = MaxNumThreads;
-    #pragma omp parallel for private(Radius,CosTheta) num_threads(NumThreads)
-    for(unsigned uMomBin=0; uMomBin<NumMomBins; uMomBin++){
-        //Momentum = GetMomentum(uMomBin);
-        for(unsigned uGrid=0; uGrid<NumGridPts; uGrid++){
-            if(PoorManRenorm!=1 && UseAnalyticSource==false) Radius = BaseSourceGrid->GetParValue(uGrid, 0)*FmToNu*PoorManRenorm;
-            else Radius = BaseSourceGrid->GetParValue(uGrid, 0)*FmToNu;
-            CosTheta = BaseSourceGrid->GetParValue(uGrid, 1);
-            for(unsigned usCh=0; usCh<NumCh; usCh++){
-                WaveFunction2[uMomBin][uGrid][usCh] =   ThetaDependentSource?
-                                                        EffectiveFunctionTheta(uMomBin, Radius, CosTheta, usCh):
-                                                        EffectiveFunction(uMomBin, Radius, usCh);
+    unsigned short NumThreads = Execution->GetTeamSize();
+
+    if(!SetUpRefPartialWaves(NumThreads)){
+        for(unsigned uMomCh=0; uMomCh<NumMomBins*NumCh; uMomCh++) WaveFun2Status[uMomCh] = 0;
+    }
+
+    //the contributions of the individual PWs are saved only if they fit within the memory limit
+    if(IncrementalTotWaveFun && (!PwTerm || (ThetaDependentSource && !PwAmplitude))){
+        const double MemoryMB = double(NumMomBins)*double(NumGridPts)*double(NumChPw+ThetaDependentSource*NumCh)*
+                                double(sizeof(complex<double>))/1048576.;
+        if(MemoryMB>IncrementalTotWaveFun){
+            if(Notifications>=nWarning)
+                printf("\033[1;33mWARNING:\033[0m The incremental evaluation of the total wave function needs %.0f MB (limit %.0f MB), switching it off\n",
+                       MemoryMB, IncrementalTotWaveFun);
+            IncrementalTotWaveFun = 0;
+            DelPwTerms();
+        }
+        else{
+            if(!PwTerm){
+                PwTerm = new complex<double>* [NumMomBins];
+                for(unsigned uMomBin=0; uMomBin<NumMomBins; uMomBin++) PwTerm[uMomBin] = new complex<double> [NumGridPts*NumChPw];
+            }
+            if(ThetaDependentSource && !PwAmplitude){
+                PwAmplitude = new complex<double>* [NumMomBins];
+                for(unsigned uMomBin=0; uMomBin<NumMomBins; uMomBin++) PwAmplitude[uMomBin] = new complex<double> [NumCh*NumGridPts];
             }
+            for(unsigned uMomCh=0; uMomCh<NumMomBins*NumCh; uMomCh++) WaveFun2Status[uMomCh] = 0;
+        }
+    }
 
-            #pragma omp atomic
-            CurrentStep++;
-            #pragma omp critical
+    //each incremental update adds the rounding errors of the replaced PW terms to the total wave function,
+    //thus after MaxNumIncr incremental updates of a channel it is summed up again from scratch
+    const unsigned short MaxNumIncr = 64;
+    for(unsigned uMomBin=0; uMomBin<NumMomBins; uMomBin++){
+        if(MomBinSelected && !MomBinSelected[uMomBin]) continue;
+        for(unsigned short usCh=0; usCh<NumCh; usCh++){
+            const unsigned uMomCh = uMomBin*NumCh+usCh;
+            if(WaveFun2Status[uMomCh]==0) WaveFun2NumIncr[uMomCh] = 0;
+            else if(WaveFun2Status[uMomCh]==1 && ++WaveFun2NumIncr[uMomCh]>MaxNumIncr){
+                WaveFun2Status[uMomCh] = 0;
+                WaveFun2NumIncr[uMomCh] = 0;
+            }
+        }
+    }
+
+    //for an angular dependent source we loop over the grid points first, so that the Legendre polynomials
+    //are evaluated only once per grid point (for all momentum bins and channels). Each thread has its own table.
+    if(ThetaDependentSource){
+        #pragma omp parallel private(Radius,CosTheta) num_threads(NumThreads)
+        {
+        double* LegPol = new double [MaxPw];
+        #pragma omp for
+        for(unsigned uGrid=0; uGrid<NumGridPts; uGrid++){
+            Radius = TotWaveFunRadius(uGrid);
+            CosTheta = FixedGrid?FixedGridCosTh[uGrid]:BaseSourceGrid->GetGridPtPar(uGrid, 1);
+            gsl_sf_legendre_Pl_array(MaxPw-1, CosTheta, LegPol);
+            for(unsigned uMomBin=0; uMomBin<NumMomBins; uMomBin++){
+                if(MomBinSelected && !MomBinSelected[uMomBin]) continue;
+                for(unsigned short usCh=0; usCh<NumCh; usCh++){
+                    UpdateTotWaveFunction(uMomBin, usCh, uGrid, Radius, LegPol);
+                }
+            }
+
+            #pragma omp atomic
+            CurrentStep+=NumSelectedMomBins;
+            #pragma omp critical
             {
                 Progress = double(CurrentStep)/TotalSteps;
                 pTotal = int(Progress*100);
@@ -2327,10 +3044,190 @@ void CATS::ComputeTotWaveFunction(const bool& ReallocateTotWaveFun){
                     pTotalOld = pTotal;
                 }
             }
+        }
+        delete [] LegPol;
+        }
+    }
+    else{
+        #pragma omp parallel for private(Radius,CosTheta) num_threads(NumThreads)
+        for(unsigned uMomBin=0; uMomBin<NumMomBins; uMomBin++){
+            if(MomBinSelected && !MomBinSelected[uMomBin]) continue;
+            //Momentum = GetMomentum(uMomBin);
+            for(unsigned uGrid=0; uGrid<NumGridPts; uGrid++){
+                Radius = TotWaveFunRadius(uGrid);
+                for(unsigned short usCh=0; usCh<NumCh; usCh++){
+                    UpdateTotWaveFunction(uMomBin, usCh, uGrid, Radius, NULL);
+                }
 
+                #pragma omp atomic
+                CurrentStep++;
+                #pragma omp critical
+                {
+                    Progress = double(CurrentStep)/TotalSteps;
+                    pTotal = int(Progress*100);
+                    if(pTotal!=pTotalOld){
+                        Time = double(dlmTimer.Stop())/1e6;
+                        Time = round((1./Progress-1.)*Time);
+                        ShowTime((long long)(Time), cdummy, 2, true, 5);
+                        if(Notifications>=nAll) printf("\r\033[K          Progress %3d%%, ETA %s",pTotal,cdummy);
+                        cout << flush;
+                        pTotalOld = pTotal;
+                    }
+                }
+
+            }
         }
     }
     if(Notifications>=nAll) printf("\r\033[K");
+    delete [] cdummy;
+
+    //the evaluated channels are up to date. Done only here, as their status is read by all threads
+    for(unsigned uMomBin=0; uMomBin<NumMomBins; uMomBin++){
+        if(MomBinSelected && !MomBinSelected[uMomBin]) continue;
+        for(unsigned short usCh=0; usCh<NumCh; usCh++) WaveFun2Status[uMomBin*NumCh+usCh] = 2;
+        for(unsigned uChPw=0; uChPw<NumChPw; uChPw++) PwTermValid[uMomBin*NumChPw+uChPw] = true;
+    }
+}
+
+void CATS::ComputeAdaptiveMomBins(const bool& TotWaveFunEvaluated, const bool& ReallocateTotWaveFun){
+    if(!MomBinStage){
+        MomBinStage = new unsigned short [NumMomBins];
+        for(unsigned uMomBin=0; uMomBin<NumMomBins; uMomBin++) MomBinStage[uMomBin]=0;
+    }
+    //the bins solved during previous calls are reused as far as possible
+    for(unsigned uMomBin=0; uMomBin<NumMomBins; uMomBin++){
+        if(!WaveFunctionUpToDate()) MomBinStage[uMomBin]=0;
+        else if(!TotWaveFunEvaluated && MomBinStage[uMomBin]>1) MomBinStage[uMomBin]=1;
+    }
+    bool Reallocate = ReallocateTotWaveFun;
+
+    //the bins used in the evaluation of the correlation function
+    bool* Active = new bool [NumMomBins];
+    //true if the interval between this active bin and the next one needs to be checked
+    bool* Refine = new bool [NumMomBins];
+    MomBinSelected = new bool [NumMomBins];
+    //the midpoints added in each iteration, together with the limits of the interval they split
+    unsigned* NewBin = new unsigned [NumMomBins];
+    unsigned* NewLow = new unsigned [NumMomBins];
+    unsigned* NewUp = new unsigned [NumMomBins];
+    unsigned NumNew;
+
+    //the starting (coarse) binning contains every CoarseStep-th bin, giving at least 8 intervals
+    unsigned CoarseStep=1;
+    while(CoarseStep*16<=NumMomBins) CoarseStep*=2;
+    NumNew=0;
+    for(unsigned uMomBin=0; uMomBin<NumMomBins; uMomBin++){
+        Active[uMomBin] = (uMomBin%CoarseStep==0 || uMomBin==NumMomBins-1);
+        Refine[uMomBin] = Active[uMomBin];
+        if(Active[uMomBin]) NewBin[NumNew++] = uMomBin;
+    }
+
+    unsigned NumSolved=0;
+    unsigned Iteration=0;
+    while(NumNew){
+        //solve the Schroedinger equation for the new bins
+        bool Needed=false;
+        for(unsigned uMomBin=0; uMomBin<NumMomBins; uMomBin++) MomBinSelected[uMomBin]=false;
+        for(unsigned uNew=0; uNew<NumNew; uNew++){
+            MomBinSelected[NewBin[uNew]] = MomBinStage[NewBin[uNew]]<1;
+            if(MomBinSelected[NewBin[uNew]]) Needed=true;
+        }
+        if(Needed) ComputeWaveFunction();
+
+        //evaluate the total wave function for the new bins
+        Needed=false;
+        for(unsigned uNew=0; uNew<NumNew; uNew++){
+            if(MomBinStage[NewBin[uNew]]<1) MomBinStage[NewBin[uNew]]=1;
+            MomBinSelected[NewBin[uNew]] = MomBinStage[NewBin[uNew]]<2;
+            if(MomBinSelected[NewBin[uNew]]) Needed=true;
+        }
+        if(Needed || Reallocate){
+            ComputeTotWaveFunction(Reallocate);
+            Reallocate = false;
+        }
+
+        //fold with the source
+        for(unsigned uNew=0; uNew<NumNew; uNew++){
+            MomBinStage[NewBin[uNew]]=2;
+            MomBinSelected[NewBin[uNew]]=true;
+        }
+        ComputedCorrFunction = false;
+        FoldSourceAndWF();
+        NumSolved += NumNew;
+
+        //compare the new midpoints to the interpolation between the limits of their interval
+        if(Iteration){
+            for(unsigned uNew=0; uNew<NumNew; uNew++){
+                const unsigned& uMid = NewBin[uNew];
+                const unsigned& uLow = NewLow[uNew];
+                const unsigned& uUp = NewUp[uNew];
+                double Weight = (GetMomentum(uMid)-GetMomentum(uLow))/(GetMomentum(uUp)-GetMomentum(uLow));
+                double Deviation = fabs(kCorrFun[uMid]-(1.-Weight)*kCorrFun[uLow]-Weight*kCorrFun[uUp]);
+                for(unsigned short usCh=0; usCh<NumCh; usCh++){
+                    for(unsigned short usPW=0; usPW<NumPW[usCh]; usPW++){
+                        if(!ShortRangePotential[usCh][usPW] || ExternalWF[usCh][usPW]) continue;
+                        double DevPS = fabs(PhaseShift[uMid][usCh][usPW]-(1.-Weight)*PhaseShift[uLow][usCh][usPW]-
+                                            Weight*PhaseShift[uUp][usCh][usPW]);
+                        if(DevPS>Deviation) Deviation=DevPS;
+                    }
+                }
+                Refine[uLow] = Deviation>AdaptiveMomBins;
+                Refine[uMid] = Refine[uLow];
+            }
+        }
+        Iteration++;
+
+        //split the intervals which need refinement
+        NumNew=0;
+        unsigned uLow=0;
+        for(unsigned uUp=1; uUp<NumMomBins; uUp++){
+            if(!Active[uUp]) continue;
+            if(Refine[uLow] && uUp-uLow>1){
+                NewBin[NumNew] = (uLow+uUp)/2;
+                NewLow[NumNew] = uLow;
+                NewUp[NumNew] = uUp;
+                NumNew++;
+            }
+            uLow = uUp;
+        }
+        for(unsigned uNew=0; uNew<NumNew; uNew++) Active[NewBin[uNew]]=true;
+    }
+
+    //the remaining bins are linearly interpolated
+    unsigned uLow=0;
+    for(unsigned uUp=1; uUp<NumMomBins; uUp++){
+        if(!Active[uUp]) continue;
+        for(unsigned uMomBin=uLow+1; uMomBin<uUp; uMomBin++){
+            double Weight = (GetMomentum(uMomBin)-GetMomentum(uLow))/(GetMomentum(uUp)-GetMomentum(uLow));
+            kCorrFun[uMomBin] = (1.-Weight)*kCorrFun[uLow]+Weight*kCorrFun[uUp];
+            kCorrFunErr[uMomBin] = (1.-Weight)*kCorrFunErr[uLow]+Weight*kCorrFunErr[uUp];
+            for(unsigned uIpBin=0; uIpBin<NumIpBins; uIpBin++){
+                kbCorrFun[uMomBin][uIpBin] = (1.-Weight)*kbCorrFun[uLow][uIpBin]+Weight*kbCorrFun[uUp][uIpBin];
+                kbCorrFunErr[uMomBin][uIpBin] = (1.-Weight)*kbCorrFunErr[uLow][uIpBin]+Weight*kbCorrFunErr[uUp][uIpBin];
+            }
+            for(unsigned short usCh=0; usCh<NumCh; usCh++){
+                for(unsigned short usPW=0; usPW<NumPW[usCh]; usPW++){
+                    if(!ShortRangePotential[usCh][usPW] || ExternalWF[usCh][usPW]) continue;
+                    PhaseShift[uMomBin][usCh][usPW] = (1.-Weight)*PhaseShift[uLow][usCh][usPW]+Weight*PhaseShift[uUp][usCh][usPW];
+                    PhaseShiftF[usCh][usPW][uMomBin] = PhaseShift[uMomBin][usCh][usPW];
+                }
+            }
+            MomBinConverged[uMomBin] = MomBinConverged[uLow] && MomBinConverged[uUp];
+        }
+        uLow = uUp;
+    }
+
+    delete [] Active;
+    delete [] Refine;
+    delete [] MomBinSelected; MomBinSelected=NULL;
+    delete [] NewBin;
+    delete [] NewLow;
+    delete [] NewUp;
+
+    ComputedWaveFunction = true;
+    ComputedCorrFunction = true;
+    if(Notifications>=nAll)
+        printf("          Evaluated %u out of %u momentum bins\n", NumSolved, NumMomBins);
 }
 
 //! N.B. the units in this function (until the result is saved) are fm and GeV!!!
@@ -2381,29 +3278,43 @@ short CATS::LoadData(const unsigned short& NumBlankHeaderLines){
     if(!WeightIp) WeightIp = new double [NumIpBins];
     if(!WeightIpError) WeightIpError = new double [NumIpBins];
 
-    FILE *InFile;
-    InFile = fopen(InputFileName, "r");
-    if(!InFile){
-        if(Notifications>=nError)
-            printf("          \033[1;31mERROR:\033[0m The file\033[0m %s cannot be opened!\n", InputFileName);
-        return 0;
-    }
-
-    fseek ( InFile , 0 , SEEK_END );
+    //the binary files (see CatsBinaryFile) are memory mapped and need no parsing
+    const bool BinaryInput = CatsBinaryFile::IsBinaryFile(InputFileName);
+    CatsBinaryFile BinFile;
+    FILE *InFile=NULL;
     long EndPos;
-    EndPos = ftell (InFile);
-    fseek ( InFile , 0 , SEEK_SET );
     long CurPos;
 
-    //Read the header lines
-    for(unsigned short us=0; us<NumBlankHeaderLines; us++){
-        if(!fgets(cdummy, 255, InFile)){
-            printf("\033[1;33mWARNING!\033[0m Possible bad input-file, error when reading from %s!\n",InputFileName);
-            continue;
+    if(BinaryInput){
+        if(!BinFile.Open(InputFileName)){
+            if(Notifications>=nError)
+                printf("          \033[1;31mERROR:\033[0m The binary file\033[0m %s is corrupted!\n", InputFileName);
+            return 0;
+        }
+        EndPos = BinFile.GetSize();
+    }
+    else{
+        InFile = fopen(InputFileName, "r");
+        if(!InFile){
+            if(Notifications>=nError)
+                printf("          \033[1;31mERROR:\033[0m The file\033[0m %s cannot be opened!\n", InputFileName);
+            return 0;
+        }
+
+        fseek ( InFile , 0 , SEEK_END );
+        EndPos = ftell (InFile);
+        fseek ( InFile , 0 , SEEK_SET );
+
+        //Read the header lines
+        for(unsigned short us=0; us<NumBlankHeaderLines; us++){
+            if(!fgets(cdummy, 255, InFile)){
+                printf("\033[1;33mWARNING!\033[0m Possible bad input-file, error when reading from %s!\n",InputFileName);
+                continue;
+            }
         }
     }
 
-    if(feof(InFile)){
+    if(!BinaryInput && feof(InFile)){
         if(Notifications>=nError){
             printf("\033[1;31m          ERROR:\033[0m Trying to read past end of file %s\n", InputFileName);
             printf("         No particle pairs were loaded :(\n");
@@ -2427,24 +3338,49 @@ short CATS::LoadData(const unsigned short& NumBlankHeaderLines){
     //unsigned* NumEvPart = new unsigned [NumIpBins];
 
     CatsParticle KittyParticle;
-    CatsDataBuffer** KittyBuffer = new CatsDataBuffer* [NumIpBins];
-    unsigned* uBuffer = new unsigned[NumIpBins];
-    //CatsDataBuffer KittyBuffer(MixingDepth,pdgID[0],pdgID[1]);
-
     CatsEvent DummyEvent(pdgID[0],pdgID[1]);
-    CatsEvent*** KittyEvent;
-    KittyEvent = new CatsEvent** [NumIpBins];
+
+    //The events are read by the master thread and sorted into mixing buffers (one per ip bin). Each full buffer is
+    //a "job", the pairs of which are build and boosted in parallel. The jobs are passed to LoadDataBuffer in the same order
+    //in which the buffers were filled, i.e. the result does not depend on the number of threads.
+    unsigned short NumThreads = Execution->GetTeamSize();
+    const unsigned MaxPendingJobs = NumThreads>1?4*NumThreads:1;
+    //each ip bin has an open (not yet full) job at any time
+    const unsigned NumJobs = MaxPendingJobs+NumIpBins;
+    CatsDataBuffer** JobBuffer = new CatsDataBuffer* [NumJobs];
+    CatsEvent*** JobEvent = new CatsEvent** [NumJobs];
+    //the consecutive number of each event read from the file. Needed to restore the state of the
+    //buffers in case we stop reading, as the events are read in advance
+    unsigned** JobEventId = new unsigned* [NumJobs];
+    bool** JobHighMult = new bool* [NumJobs];
+    unsigned* JobIpBin = new unsigned [NumJobs];
+    unsigned* JobNumEvents = new unsigned [NumJobs];
+    unsigned* FreeJob = new unsigned [NumJobs];
+    unsigned NumFreeJobs = 0;
+    unsigned* PendingJob = new unsigned [NumJobs];
+    unsigned NumPendingJobs;
+    unsigned* OpenJob = new unsigned [NumIpBins];
+    unsigned JobId;
+
+    for(unsigned uJob=0; uJob<NumJobs; uJob++){
+        JobBuffer[uJob] = new CatsDataBuffer(MixingDepth,pdgID[0],pdgID[1]);
+        JobEvent[uJob] = new CatsEvent* [MixingDepth];
+        JobEventId[uJob] = new unsigned [MixingDepth];
+        JobHighMult[uJob] = new bool [MixingDepth];
+        for(unsigned uDepth=0; uDepth<MixingDepth; uDepth++){
+            JobEvent[uJob][uDepth] = new CatsEvent(pdgID[0],pdgID[1]);
+        }
+        JobIpBin[uJob] = 0;
+        JobNumEvents[uJob] = 0;
+        FreeJob[NumFreeJobs++] = NumJobs-1-uJob;
+    }
 
     for(unsigned uIpBin=0; uIpBin<NumIpBins; uIpBin++){
         //NumEvPart[uIpBin] = 0;
         NumSePairsIp[uIpBin] = 0;
         NumEvents[uIpBin] = 0;
-        uBuffer[uIpBin] = 0;
-        KittyBuffer[uIpBin] = new CatsDataBuffer(MixingDepth,pdgID[0],pdgID[1]);
-        KittyEvent[uIpBin] = new CatsEvent* [MixingDepth];
-        for(unsigned uDepth=0; uDepth<MixingDepth; uDepth++){
-            KittyEvent[uIpBin][uDepth] = new CatsEvent(pdgID[0],pdgID[1]);
-        }
+        OpenJob[uIpBin] = FreeJob[--NumFreeJobs];
+        JobIpBin[OpenJob[uIpBin]] = uIpBin;
     }
 
     unsigned WhichIpBin;
@@ -2479,127 +3415,190 @@ short CATS::LoadData(const unsigned short& NumBlankHeaderLines){
     unsigned RejectedHighMultEvents = 0;
     const int HighMultLimit = 128;
 
-    //!---Iteration over all events---
-    while(!feof(InFile)){
-        SkipThisEvent = false;
-        if(NumPairs>=MaxTotPairs) break;
-        if(NumTotalPairs>=MaxPairsToRead) break;
-
-        if(!fscanf(InFile,"%i %i %lf %lf",&EventNumber,&NumPartInEvent,&ImpPar,&fDummy)){
-            printf("\033[1;33mWARNING!\033[0m Possible bad input-file, error when reading from %s!\n",InputFileName);
-            continue;
-        }
-
-        NewInterestingEvent = false;
+    unsigned EventId = 0;
+    unsigned LastEventId;
+    bool StopReading = false;
+    //in the last batch we process the buffers which are not full
+    bool LastBatch = false;
+    unsigned NumUnusedJobs;
+    unsigned* UnusedJob = new unsigned [NumJobs];
 
-        ImpPar = fabs(ImpPar);
-        if(ImpPar<IpBin[0] || ImpPar>IpBin[NumIpBins]) {SkipThisEvent=true; WhichIpBin=0;}
-        else WhichIpBin = GetIpBin(ImpPar);
-        if(WhichIpBin>=NumIpBins) {SkipThisEvent=true; WhichIpBin=0;}
+    while(true){
+        NumPendingJobs = 0;
+        if(!LastBatch){
+            if(NumPairs>=MaxTotPairs || NumTotalPairs>=MaxPairsToRead) StopReading = true;
+            //!---Iteration over the events, until enough buffers are full---
+            while(!StopReading && NumPendingJobs<MaxPendingJobs){
+                if(!BinaryInput && feof(InFile)) {StopReading=true; break;}
+                SkipThisEvent = false;
+
+                if(BinaryInput){
+                    if(!BinFile.NextEvent(EventNumber,NumPartInEvent,ImpPar)) {StopReading=true; break;}
+                }
+                else if(!fscanf(InFile,"%i %i %lf %lf",&EventNumber,&NumPartInEvent,&ImpPar,&fDummy)){
+                    printf("\033[1;33mWARNING!\033[0m Possible bad input-file, error when reading from %s!\n",InputFileName);
+                    continue;
+                }
 
-        TotNumEvents++;
-        if(NumPartInEvent>HighMultLimit) RejectedHighMultEvents++;
+                NewInterestingEvent = false;
 
-        //!---Iteration over all particles in this event---
-        for(int iPart=0; iPart<NumPartInEvent; iPart++){
-            if(NumPairs>=MaxTotPairs) break;
-            if(NumTotalPairs>=MaxPairsToRead) break;
+                ImpPar = fabs(ImpPar);
+                if(ImpPar<IpBin[0] || ImpPar>IpBin[NumIpBins]) {SkipThisEvent=true; WhichIpBin=0;}
+                else WhichIpBin = GetIpBin(ImpPar);
+                if(WhichIpBin>=NumIpBins) {SkipThisEvent=true; WhichIpBin=0;}
 
-            KittyParticle.ReadFromOscarFile(InFile);
-            if(TransportRenorm!=1){
-                KittyParticle.RenormSpacialCoordinates(TransportRenorm);
-            }
+                TotNumEvents++;
+                if(NumPartInEvent>HighMultLimit) RejectedHighMultEvents++;
 
-            if(NumPartInEvent>HighMultLimit) continue;
+                JobId = OpenJob[WhichIpBin];
+                CatsEvent* KittyEvent = JobEvent[JobId][JobNumEvents[JobId]];
 
-            //sometimes one might go beyond the limit of the file
-            if(ftell(InFile)>=EndPos)continue;
+                //!---Iteration over all particles in this event---
+                for(int iPart=0; iPart<NumPartInEvent; iPart++){
+                    //sometimes one might go beyond the limit of the file
+                    if(BinaryInput) BinFile.GetParticle(iPart,KittyParticle);
+                    else if(!KittyParticle.ReadFromOscarFile(InFile)) continue;
+                    if(TransportRenorm!=1){
+                        KittyParticle.RenormSpacialCoordinates(TransportRenorm);
+                    }
 
-            if(SkipThisEvent) continue;
+                    if(NumPartInEvent>HighMultLimit) continue;
 
-            if(KittyParticle.GetE()==0){
-                if(Notifications>=nWarning)
-                    printf("\033[1;33mWARNING!\033[0m Possible bad input-file, there are particles with zero energy!\n");
-                continue;
-            }
+                    if(SkipThisEvent) continue;
 
-            if(KittyParticle.GetPid()!=pdgID[0] && KittyParticle.GetPid()!=pdgID[1])
-                continue; //don't save this particle if it is of the wrong type
+                    if(KittyParticle.GetE()==0){
+                        if(Notifications>=nWarning)
+                            printf("\033[1;33mWARNING!\033[0m Possible bad input-file, there are particles with zero energy!\n");
+                        continue;
+                    }
 
-            if(!NewInterestingEvent){
-                NewInterestingEvent = true;
-                NumEvents[WhichIpBin]++;
-            }
+                    if(KittyParticle.GetPid()!=pdgID[0] && KittyParticle.GetPid()!=pdgID[1])
+                        continue; //don't save this particle if it is of the wrong type
 
-            KittyEvent[WhichIpBin][uBuffer[WhichIpBin]]->AddParticle(KittyParticle);
+                    if(!NewInterestingEvent){
+                        NewInterestingEvent = true;
+                        NumEvents[WhichIpBin]++;
+                    }
 
-        }//for(int iPart=0; iPart<NumPartInEvent; iPart++)
+                    KittyEvent->AddParticle(KittyParticle);
 
-        KittyEvent[WhichIpBin][uBuffer[WhichIpBin]]->ComputeParticlePairs(TauCorrection);
+                }//for(int iPart=0; iPart<NumPartInEvent; iPart++)
 
-        KittyBuffer[WhichIpBin]->SetEvent(uBuffer[WhichIpBin], *KittyEvent[WhichIpBin][uBuffer[WhichIpBin]]);
+                JobEventId[JobId][JobNumEvents[JobId]] = EventId++;
+                JobHighMult[JobId][JobNumEvents[JobId]] = NumPartInEvent>HighMultLimit;
+                JobNumEvents[JobId]++;
 
-        uBuffer[WhichIpBin]++;
+                //if the buffer is full -> schedule it for processing and open a new one
+                if(JobNumEvents[JobId]==MixingDepth){
+                    PendingJob[NumPendingJobs++] = JobId;
+                    OpenJob[WhichIpBin] = FreeJob[--NumFreeJobs];
+                    JobIpBin[OpenJob[WhichIpBin]] = WhichIpBin;
+                    JobNumEvents[OpenJob[WhichIpBin]] = 0;
+                    for(unsigned uDepth=0; uDepth<MixingDepth; uDepth++){
+                        JobEvent[OpenJob[WhichIpBin]][uDepth]->Reset();
+                    }
+                }
 
-        //if the buffer is full -> empty it!
-        //note that if it happens the we leave the while loop before emptying the buffer,
-        //uBuffer will be != than zero! use this condition to empty the buffer when exiting the loop!
-        if(uBuffer[WhichIpBin]==MixingDepth){
-            SelectedSePairs=LoadDataBuffer(WhichIpBin, KittyBuffer[WhichIpBin]);
+                CurPos = BinaryInput?BinFile.GetPosition():ftell(InFile);
+                pMaxPairsToRead = double(NumTotalPairs)/double(MaxPairsToRead);//
+        //        pMaxPairsToLoad = double(NumPairs)/double(MaxTotPairs);
+                pFile = double(CurPos)/double(EndPos);//what fraction of the file has been read
+                ProgressLoad = pMaxPairsToRead>pFile?pMaxPairsToRead:pFile;
+        //        ProgressLoad = pMaxPairsToLoad>ProgressLoad?pMaxPairsToLoad:ProgressLoad;
+
+                pMaxPairsPerBin = 1;
+                for(unsigned uMomBin=0; uMomBin<NumMomBins; uMomBin++){
+                    for(unsigned uIpBin=0; uIpBin<NumIpBins; uIpBin++){
+                        //select the smallest possible pMaxPairsPerBin
+                        pTemp = float(LoadedPairsPerBin[uMomBin][uIpBin])/float(MaxPairsPerBin);
+                        if(pTemp<pMaxPairsPerBin) pMaxPairsPerBin=pTemp;
+                    }
+                }
+                ProgressLoad = pMaxPairsPerBin>ProgressLoad?pMaxPairsPerBin:ProgressLoad;
 
-            for(unsigned uDepth=0; uDepth<MixingDepth; uDepth++){
-                KittyEvent[WhichIpBin][uDepth]->Reset();
+                pTotal = int(ProgressLoad*100);
+                if(pTotal!=pTotalOld){
+                    Time = double(dlmTimer.Stop())/1e6;
+                    //EtaPerBin = round((1./pMaxPairsPerBin-1.)*Time);
+                    //EtaToLoad = round((1./pMaxPairsToLoad-1.)*Time);
+                    Time = round((1./ProgressLoad-1.)*Time);
+                    ShowTime((long long)(Time), cdummy, 2, true, 5);
+                    if(Notifications>=nAll)
+                        printf("\r\033[K          Progress %3d%%, ETA %s",pTotal,cdummy);
+                    ProgressBar = true;
+                    cout << flush;
+                    pTotalOld = pTotal;
+                }
             }
-            NumTotalPairs+=KittyBuffer[WhichIpBin]->GetNumPairs();
-            TotalNumSePairs+=SelectedSePairs;
-            NumSePairsIp[WhichIpBin]+=SelectedSePairs;
-            uBuffer[WhichIpBin]=0;
         }
-
-        CurPos = ftell (InFile);
-        pMaxPairsToRead = double(NumTotalPairs)/double(MaxPairsToRead);//
-//        pMaxPairsToLoad = double(NumPairs)/double(MaxTotPairs);
-        pFile = double(CurPos)/double(EndPos);//what fraction of the file has been read
-        ProgressLoad = pMaxPairsToRead>pFile?pMaxPairsToRead:pFile;
-//        ProgressLoad = pMaxPairsToLoad>ProgressLoad?pMaxPairsToLoad:ProgressLoad;
-
-        pMaxPairsPerBin = 1;
-        for(unsigned uMomBin=0; uMomBin<NumMomBins; uMomBin++){
+        else{
+            //empty the buffers for the last time (in order of the ip bins)
             for(unsigned uIpBin=0; uIpBin<NumIpBins; uIpBin++){
-                //select the smallest possible pMaxPairsPerBin
-                pTemp = float(LoadedPairsPerBin[uMomBin][uIpBin])/float(MaxPairsPerBin);
-                if(pTemp<pMaxPairsPerBin) pMaxPairsPerBin=pTemp;
+                for(unsigned uJob=0; uJob<NumUnusedJobs; uJob++){
+                    if(JobIpBin[UnusedJob[uJob]]==uIpBin && JobNumEvents[UnusedJob[uJob]]){
+                        PendingJob[NumPendingJobs++] = UnusedJob[uJob];
+                    }
+                }
             }
         }
-        ProgressLoad = pMaxPairsPerBin>ProgressLoad?pMaxPairsPerBin:ProgressLoad;
 
-        pTotal = int(ProgressLoad*100);
-        if(pTotal!=pTotalOld){
-            Time = double(dlmTimer.Stop())/1e6;
-            //EtaPerBin = round((1./pMaxPairsPerBin-1.)*Time);
-            //EtaToLoad = round((1./pMaxPairsToLoad-1.)*Time);
-            Time = round((1./ProgressLoad-1.)*Time);
-            ShowTime((long long)(Time), cdummy, 2, true, 5);
-            if(Notifications>=nAll)
-                printf("\r\033[K          Progress %3d%%, ETA %s",pTotal,cdummy);
-            ProgressBar = true;
-            cout << flush;
-            pTotalOld = pTotal;
+        //if the buffer needs to be emptied, make sure that we do not have any "leftovers" saved in the buffer!
+        #pragma omp parallel for schedule(dynamic) num_threads(NumThreads)
+        for(unsigned uJob=0; uJob<NumPendingJobs; uJob++){
+            const unsigned& WhichJob = PendingJob[uJob];
+            for(unsigned uDepth=0; uDepth<MixingDepth; uDepth++){
+                if(uDepth<JobNumEvents[WhichJob]){
+                    JobEvent[WhichJob][uDepth]->ComputeParticlePairs(TauCorrection);
+                    JobBuffer[WhichJob]->SetEvent(uDepth, *JobEvent[WhichJob][uDepth]);
+                }
+                else{
+                    JobBuffer[WhichJob]->SetEvent(uDepth, DummyEvent);
+                }
+            }
+            JobBuffer[WhichJob]->GoBabyGo(TauCorrection);
         }
 
-    }//while(!feof(InFile))
+        NumUnusedJobs = 0;
+        for(unsigned uJob=0; uJob<NumPendingJobs; uJob++){
+            JobId = PendingJob[uJob];
+            SelectedSePairs = LoadDataBuffer(JobIpBin[JobId], JobBuffer[JobId]);
+            NumTotalPairs+=JobBuffer[JobId]->GetNumPairs();
+            TotalNumSePairs+=SelectedSePairs;
+            NumSePairsIp[JobIpBin[JobId]]+=SelectedSePairs;
+            FreeJob[NumFreeJobs++] = JobId;
+            JobNumEvents[JobId] = 0;
+            if(LastBatch) continue;
+            //the events following this buffer would not have been read at all => remove them from the remaining buffers
+            if(NumPairs>=MaxTotPairs || NumTotalPairs>=MaxPairsToRead){
+                LastEventId = JobEventId[JobId][MixingDepth-1];
+                for(unsigned uJob2=uJob+1; uJob2<NumPendingJobs; uJob2++){
+                    UnusedJob[NumUnusedJobs++] = PendingJob[uJob2];
+                }
+                for(unsigned uIpBin=0; uIpBin<NumIpBins; uIpBin++){
+                    UnusedJob[NumUnusedJobs++] = OpenJob[uIpBin];
+                }
+                for(unsigned uJob2=0; uJob2<NumUnusedJobs; uJob2++){
+                    JobId = UnusedJob[uJob2];
+                    while(JobNumEvents[JobId] && JobEventId[JobId][JobNumEvents[JobId]-1]>LastEventId){
+                        JobNumEvents[JobId]--;
+                        TotNumEvents--;
+                        if(JobHighMult[JobId][JobNumEvents[JobId]]) RejectedHighMultEvents--;
+                    }
+                }
+                StopReading = true;
+                break;
+            }
+        }
 
-    for(unsigned uIpBin=0; uIpBin<NumIpBins; uIpBin++){
-        //empty the buffer for the last time
-        if(uBuffer[uIpBin]){
-            //if the buffer needs to be emptied, make sure that we do not have any "leftovers" saved in the buffer!
-            for(unsigned uLeftOver=uBuffer[uIpBin]; uLeftOver<MixingDepth; uLeftOver++){
-                KittyBuffer[uIpBin]->SetEvent(uLeftOver, DummyEvent);
+        if(LastBatch) break;
+        if(StopReading){
+            LastBatch = true;
+            //we reached the end of the file, all full buffers were processed
+            if(!NumUnusedJobs){
+                for(unsigned uIpBin=0; uIpBin<NumIpBins; uIpBin++){
+                    UnusedJob[NumUnusedJobs++] = OpenJob[uIpBin];
+                }
             }
-            SelectedSePairs = LoadDataBuffer(uIpBin, KittyBuffer[uIpBin]);
-            NumTotalPairs+=KittyBuffer[uIpBin]->GetNumPairs();
-            TotalNumSePairs+=SelectedSePairs;
-            NumSePairsIp[uIpBin]+=SelectedSePairs;
         }
     }
 
@@ -2650,7 +3649,7 @@ short CATS::LoadData(const unsigned short& NumBlankHeaderLines){
             WeightIpError[uIpBin] = 0;
         }
     }
-    fclose(InFile);
+    if(InFile) fclose(InFile);
 
 /*
     for(unsigned uMomBin=0; uMomBin<NumMomBins; uMomBin++){
@@ -2658,12 +3657,14 @@ short CATS::LoadData(const unsigned short& NumBlankHeaderLines){
     }
     delete [] pIpMomBin;
 */
-    for(unsigned uIpBin=0; uIpBin<NumIpBins; uIpBin++){
+    for(unsigned uJob=0; uJob<NumJobs; uJob++){
         for(unsigned uDepth=0; uDepth<MixingDepth; uDepth++){
-            delete KittyEvent[uIpBin][uDepth];
+            delete JobEvent[uJob][uDepth];
         }
-        delete KittyBuffer[uIpBin];
-        delete [] KittyEvent[uIpBin];
+        delete JobBuffer[uJob];
+        delete [] JobEvent[uJob];
+        delete [] JobEventId[uJob];
+        delete [] JobHighMult[uJob];
     }
 
     delete [] cdummy;
@@ -2671,17 +3672,24 @@ short CATS::LoadData(const unsigned short& NumBlankHeaderLines){
     delete [] NumEvents;
     delete [] NumSePairsIp;
 
-    delete [] KittyBuffer;
-    delete [] KittyEvent;
-    delete [] uBuffer;
+    delete [] JobBuffer;
+    delete [] JobEvent;
+    delete [] JobEventId;
+    delete [] JobHighMult;
+    delete [] JobIpBin;
+    delete [] JobNumEvents;
+    delete [] FreeJob;
+    delete [] PendingJob;
+    delete [] OpenJob;
+    delete [] UnusedJob;
 
     return RejectedHighMultEvents?-1:1;
 }
 
 //!CHECK FOR THE MAX NUM PAIRS!
 //return the number of same event pairs that pass our basic selection criteria
+//N.B. the pairs in the buffer should already be computed (GoBabyGo)
 unsigned CATS::LoadDataBuffer(const unsigned& WhichIpBin, CatsDataBuffer* KittyBuffer){
-    KittyBuffer->GoBabyGo(TauCorrection);
 
     const CatsParticlePair* PairDif;
     const CatsLorentzVector* PairSum;
@@ -2791,6 +3799,7 @@ void CATS::FoldSourceAndWF(){
     }
     else if(!ComputedCorrFunction){
         for(unsigned uMomBin=0; uMomBin<NumMomBins; uMomBin++){
+            if(MomBinSelected && !MomBinSelected[uMomBin]) continue;
             kCorrFun[uMomBin] = 0;
             kCorrFunErr[uMomBin] = 0;
             for(unsigned uIpBin=0; uIpBin<NumIpBins; uIpBin++){
@@ -2805,20 +3814,43 @@ void CATS::FoldSourceAndWF(){
     //in such a case before folding the date one needs to update the values for the source!
     if(!SourceUpdated) UpdateSourceGrid();
 
-    unsigned NumGridPts;
-    double SourceVal;
-    double WaveFunVal;
-    double Integrand;
+    const bool FixedGrid = UseFixedSourceGrid();
+    unsigned short NumThreads = Execution->GetTeamSize();
+    //the momentum dependent fixed grid source is evaluated in parallel
+    if(FixedGrid && AnaSourcePar) AnaSourcePar->SetNumThreads(NumThreads);
+
+    //all grids are build based on BaseSourceGrid (or are the fixed grid), i.e. they share the same points
+    //and the SourceMinRad-SourceMaxRad cut can be evaluated only once
+    const unsigned NumPts = WaveFunction2?NumGridPts:0;
+    double* InRange = new double [NumPts];
+    for(unsigned uGrid=0; uGrid<NumPts; uGrid++){
+        double Radius = (FixedGrid?FixedGridRad[uGrid]:BaseSourceGrid->GetGridPtPar(uGrid, 0))*FmToNu;
+        InRange[uGrid] = (Radius<SourceMinRad || Radius>SourceMaxRad)?0:1;
+    }
+
+    #pragma omp parallel num_threads(NumThreads)
+    {
+    //the source, its error and the channel-weighted |psi|^2 at the grid points
+    double* Source = new double [NumPts];
+    double* SourceErr = new double [NumPts];
+    double* WaveFun = new double [NumPts];
     double SourceInt;
     double SourceIntCut;
-    unsigned short NumThreads = omp_get_num_procs();
-    if(NumThreads>MaxNumThreads) NumThreads = MaxNumThreads;
-    unsigned uMomBinSource;
-    #pragma omp parallel for private(NumGridPts,SourceVal,WaveFunVal,Integrand,SourceInt,SourceIntCut) num_threads(NumThreads)
+    #pragma omp for
     for(unsigned uMomBin=0; uMomBin<NumMomBins; uMomBin++){
-        uMomBinSource = MomDepSource?uMomBin:0;
+        if(MomBinSelected && !MomBinSelected[uMomBin]) continue;
+        const unsigned uMomBinSource = MomDepSource?uMomBin:0;
         kCorrFun[uMomBin] = 0;
         kCorrFunErr[uMomBin] = 0;
+
+        for(unsigned uGrid=0; uGrid<NumPts; uGrid++) WaveFun[uGrid]=0;
+        for(unsigned short usCh=0; usCh<NumCh && NumPts; usCh++){
+            const double Weight = ChannelWeight[usCh];
+            const double* WaveFunCh = &WaveFunction2[uMomBin][usCh*NumPts];
+            #pragma omp simd
+            for(unsigned uGrid=0; uGrid<NumPts; uGrid++) WaveFun[uGrid] += Weight*WaveFunCh[uGrid];
+        }
+
         for(unsigned uIpBin=0; uIpBin<NumIpBins; uIpBin++){
             //perform the k,b analysis only for a data-source which has at least 2 b-bins
             if(UseAnalyticSource || NumIpBins<=1) continue;
@@ -2828,44 +3860,21 @@ void CATS::FoldSourceAndWF(){
                 kbCorrFunErr[uMomBin][uIpBin] = 1e6;
                 continue;
             }
-            kbCorrFun[uMomBin][uIpBin] = 0;
-            kbCorrFunErr[uMomBin][uIpBin] = 0;
 
-            NumGridPts = kbSourceGrid[uMomBinSource][uIpBin]->GetNumEndNodes();
-            SourceInt = 0;
-            SourceIntCut = 0;uMomBinSource = MomDepSource?uMomBin:0;
-            for(unsigned uGrid=0; uGrid<NumGridPts; uGrid++){
-                double Radius = kbSourceGrid[uMomBinSource][uIpBin]->GetParValue(uGrid, 0)*FmToNu;
-                //this should return zero in case of !ThetaDependentSource,
-                //maybe worth doing a QA to make sure
-                //CosTheta = kbSourceGrid[uMomBin][uIpBin]->GetParValue(uGrid, 1);
-                SourceVal = kbSourceGrid[uMomBinSource][uIpBin]->GetGridValue(uGrid);
-                if(!SourceVal) continue;
-                SourceInt += SourceVal;
-                if(Radius<SourceMinRad || Radius>SourceMaxRad) {continue;}
-                SourceIntCut += SourceVal;
-                WaveFunVal=0;
-                for(unsigned usCh=0; usCh<NumCh; usCh++) WaveFunVal+=(WaveFunction2[uMomBin][uGrid][usCh])*ChannelWeight[usCh];
-                Integrand = SourceVal*WaveFunVal;
-                kbCorrFun[uMomBin][uIpBin] += Integrand;
-                kbCorrFunErr[uMomBin][uIpBin] += pow(Integrand*kbSourceGrid[uMomBinSource][uIpBin]->GetGridError(uGrid),2);
-            }//uGrid
+            FlattenSourceGrid(kbSourceGrid[uMomBinSource][uIpBin], NumPts, Source, SourceErr);
+            FoldKernel(NumPts, Source, SourceErr, InRange, WaveFun, SourceInt, SourceIntCut,
+                       kbCorrFun[uMomBin][uIpBin], kbCorrFunErr[uMomBin][uIpBin]);
 
             //ideally this should not happen, but in case it does (i.e. the source is normalized to value above 1)
             //here this is corrected for
             if(SourceInt>1+1e-4){
                 if(Notifications>=nWarning)
                     printf("\033[1;33mWARNING:\033[0m The source had to be renormalized (Integrated value=%.4e), please check the validity of your input function!\n",SourceInt);
-//if(AnaSourcePar)
-//printf("AnaSourcePar: p0=%e; p1=%e",AnaSourcePar->GetParameter(0),AnaSourcePar->GetParameter(1));
-//if(ForwardedSourcePar)
-//printf("ForwardedSourcePar: p0=%e; p1=%e",ForwardedSourcePar->GetParameter(0),ForwardedSourcePar->GetParameter(1));
                 kbCorrFun[uMomBin][uIpBin] /= SourceInt;
                 kbCorrFunErr[uMomBin][uIpBin] = sqrt(kbCorrFunErr[uMomBin][uIpBin])/SourceInt;
                 SourceIntCut/=SourceInt;
                 SourceInt=1.;
             }
-//printf("\033[1;36mDEBUG (1):\033[0m Integrated value=%.4e\n",SourceInt);
             //if the source is assumed normalized, any deviation below unity is considered to be an effect of a
             //long-range tail that is unaccounted for due to the numerical precision. This tail should result in
             //a flat residual that is added to the correlation
@@ -2890,72 +3899,100 @@ void CATS::FoldSourceAndWF(){
         }
 
         if( UseAnalyticSource || NumIpBins<=1 || MixingDepth==1 ){
-            if(!kSourceGrid[uMomBinSource]){
+            const double* SourcePtr = Source;
+            if(FixedGrid){
+                //for a momentum dependent source, the fixed grid is evaluated only here
+                double SourceError = FixedGridSourceError;
+                if(MomDepSource && SourceTeamSize(NumThreads)>1) SourceError = EvalFixedGridSource(GetMomentum(uMomBin), Source);
+                else if(MomDepSource){
+                    #pragma omp critical(CATS_FixedGridSource)
+                    SourceError = EvalFixedGridSource(GetMomentum(uMomBin), Source);
+                }
+                else SourcePtr = FixedGridSource;
+                for(unsigned uGrid=0; uGrid<NumPts; uGrid++) SourceErr[uGrid] = SourceError;
+            }
+            else if(!kSourceGrid || !kSourceGrid[uMomBinSource]){
                 kCorrFunErr[uMomBin] = 1e6;
+                continue;
             }
             else{
-                NumGridPts = kSourceGrid[uMomBinSource]->GetNumEndNodes();
-                SourceInt = 0;
-                SourceIntCut = 0;
-//printf("\033[1;36m DEBUG (2):\033[0m NumGridPts=%u\n",NumGridPts);
-                for(unsigned uGrid=0; uGrid<NumGridPts; uGrid++){
-                    double Radius = kSourceGrid[uMomBinSource]->GetParValue(uGrid, 0)*FmToNu;
-                    //this should return zero in case of !ThetaDependentSource,
-                    //maybe worth doing a QA to make sure
-                    //CosTheta = kSourceGrid[uMomBin]->GetParValue(uGrid, 1);
-                    SourceVal = kSourceGrid[uMomBinSource]->GetGridValue(uGrid);
-                    if(!SourceVal) continue;
-                    SourceInt += SourceVal;
-                    if(Radius<SourceMinRad || Radius>SourceMaxRad) {continue;}
-                    SourceIntCut += SourceVal;
-//printf("\033[1;36m  DEBUG (2):\033[0m SourceVal=%.4e\n",SourceVal);
-                    WaveFunVal=0;
-                    for(unsigned usCh=0; usCh<NumCh; usCh++) WaveFunVal+=(WaveFunction2[uMomBin][uGrid][usCh])*ChannelWeight[usCh];
-                    Integrand = SourceVal*WaveFunVal;
-                    kCorrFun[uMomBin] += Integrand;
-                    kCorrFunErr[uMomBin] += pow(Integrand*kSourceGrid[uMomBinSource]->GetGridError(uGrid),2);
-                }//uGrid
-
-                //ideally this should not happen, but in case it does (i.e. the source is normalized to value above 1)
-                //here this is corrected for
-                if(SourceInt>1+1e-4){
-                    if(Notifications>=nWarning)
-                        printf("\033[1;33mWARNING:\033[0m The source had to be renormalized (Integrated value=%.4e), please check the validity of your input function!\n",SourceInt);
-//printf(" SourceInt=%f\n",SourceInt);
-//if(AnaSourcePar)
-//printf("AnaSourcePar: p0=%e; p1=%e\n",AnaSourcePar->GetParameter(0),AnaSourcePar->GetParameter(1));
-//if(ForwardedSourcePar)
-//printf("ForwardedSourcePar: p0=%e; p1=%e\n",ForwardedSourcePar->GetParameter(0),ForwardedSourcePar->GetParameter(1));
-                    kCorrFun[uMomBin] /= SourceInt;
-                    kCorrFunErr[uMomBin] = sqrt(kCorrFunErr[uMomBin])/SourceInt;
-                    SourceIntCut/=SourceInt;
-                    SourceInt=1.;
-                }
-//printf("\033[1;36mDEBUG (2):\033[0m Integrated value=%.4e\n",SourceInt);
-                //if the source is assumed normalized, any deviation below unity is considered to be an effect of a
-                //long-range tail that is unaccounted for due to the numerical precision. This tail should result in
-                //a flat residual that is added to the correlation
-                if(NormalizedSource && SourceIntCut<1.){
-                    kCorrFun[uMomBin] += 1.-double(SourceIntCut);
-                    kCorrFunErr[uMomBin] = sqrt(kCorrFunErr[uMomBin]);
-                    //printf("Added %f to C(%.0f)\n",1.-double(SourceIntCut),GetMomentum(uMomBin));
-                }
-                //else simply re-normalize the source to the total value of the integral (even if below 1)
-                //I am not sure if this even makes sense, consider in the future to use only the NormalizedSource case
-                else{
-//printf("We are in a questionable state: %f at C(%.0f)\n",SourceIntCut,GetMomentum(uMomBin));
-                    kCorrFun[uMomBin] *= double(SourceInt)/double(SourceIntCut);
-                    kCorrFunErr[uMomBin] = sqrt(kCorrFunErr[uMomBin])*double(SourceInt)/double(SourceIntCut);
-                }
-
-                kCorrFun[uMomBin] *= double(SourceInt)/double(SourceIntCut);
-                kCorrFunErr[uMomBin] = sqrt(kCorrFunErr[uMomBin])*double(SourceInt)/double(SourceIntCut);
+                FlattenSourceGrid(kSourceGrid[uMomBinSource], NumPts, Source, SourceErr);
             }
+            FoldKernel(NumPts, SourcePtr, SourceErr, InRange, WaveFun, SourceInt, SourceIntCut,
+                       kCorrFun[uMomBin], kCorrFunErr[uMomBin]);
+            NormalizeCorrFun(kCorrFun[uMomBin], kCorrFunErr[uMomBin], SourceInt, SourceIntCut);
         }
     }
+    delete [] Source;
+    delete [] SourceErr;
+    delete [] WaveFun;
+    }
+
+    delete [] InRange;
     ComputedCorrFunction = true;
 }
 
+void CATS::FlattenSourceGrid(CATSelder* Grid, const unsigned& NumPts, double* Source, double* SourceErr) const{
+    for(unsigned uGrid=0; uGrid<NumPts; uGrid++){
+        Source[uGrid] = Grid->GetGridPtValue(uGrid);
+        SourceErr[uGrid] = Grid->GetGridPtError(uGrid);
+    }
+}
+
+void CATS::FoldKernel(const unsigned& NumPts, const double* Source, const double* SourceErr, const double* InRange,
+                      const double* WaveFun, double& SourceInt, double& SourceIntCut, double& CorrFun, double& CorrFunErr) const{
+    double SrcInt=0;
+    double SrcIntCut=0;
+    double Ck=0;
+    double CkErr=0;
+    #pragma omp simd reduction(+:SrcInt,SrcIntCut,Ck,CkErr)
+    for(unsigned uGrid=0; uGrid<NumPts; uGrid++){
+        //the values are selected rather than multiplied, as the wave function (or the error) might not be finite
+        //at the points that are cut or have a zero source. These are skipped, as in the non-vectorized version
+        const bool Use = InRange[uGrid]&&Source[uGrid];
+        const double SourceCut = InRange[uGrid]?Source[uGrid]:0;
+        const double Integrand = Use?Source[uGrid]*WaveFun[uGrid]:0;
+        const double IntegrandErr = Use?Integrand*SourceErr[uGrid]:0;
+        SrcInt += Source[uGrid];
+        SrcIntCut += SourceCut;
+        Ck += Integrand;
+        CkErr += IntegrandErr*IntegrandErr;
+    }
+    SourceInt = SrcInt;
+    SourceIntCut = SrcIntCut;
+    CorrFun = Ck;
+    CorrFunErr = CkErr;
+}
+
+void CATS::NormalizeCorrFun(double& CorrFun, double& CorrFunErr, double SourceInt, double SourceIntCut) const{
+    //ideally this should not happen, but in case it does (i.e. the source is normalized to value above 1)
+    //here this is corrected for
+    if(SourceInt>1+1e-4){
+        if(Notifications>=nWarning)
+            printf("\033[1;33mWARNING:\033[0m The source had to be renormalized (Integrated value=%.4e), please check the validity of your input function!\n",SourceInt);
+        CorrFun /= SourceInt;
+        CorrFunErr = sqrt(CorrFunErr)/SourceInt;
+        SourceIntCut/=SourceInt;
+        SourceInt=1.;
+    }
+    //if the source is assumed normalized, any deviation below unity is considered to be an effect of a
+    //long-range tail that is unaccounted for due to the numerical precision. This tail should result in
+    //a flat residual that is added to the correlation
+    if(NormalizedSource && SourceIntCut<1.){
+        CorrFun += 1.-double(SourceIntCut);
+        CorrFunErr = sqrt(CorrFunErr);
+    }
+    //else simply re-normalize the source to the total value of the integral (even if below 1)
+    //I am not sure if this even makes sense, consider in the future to use only the NormalizedSource case
+    else{
+        CorrFun *= double(SourceInt)/double(SourceIntCut);
+        CorrFunErr = sqrt(CorrFunErr)*double(SourceInt)/double(SourceIntCut);
+    }
+
+    CorrFun *= double(SourceInt)/double(SourceIntCut);
+    CorrFunErr = sqrt(CorrFunErr)*double(SourceInt)/double(SourceIntCut);
+}
+
 void CATS::SortAllData(){
     if(NumPairs<=1) return;
     DLM_Sort < int64_t, unsigned > SortTool;
@@ -2973,6 +4010,13 @@ void CATS::SortAllData(){
 }
 
 void CATS::SetUpSourceGrid(){
+    DelSourceGrid();
+    if(UseFixedSourceGrid()){
+        SetUpFixedSourceGrid();
+        return;
+    }
+    DelFixedGrid();
+
     double LIMIT = GridEpsilon;
     if(!LIMIT){
         if(ThetaDependentSource) LIMIT=1./16384.;
@@ -2988,6 +4032,10 @@ void CATS::SetUpSourceGrid(){
     }
     short DIM = ThetaDependentSource?2:1;
     unsigned MAXGRIDPTS = uipow(2,MAXDEPTH*DIM);
+    unsigned short NumThreads = Execution->GetTeamSize();
+    //the grid is build and updated in parallel, with separate source parameters for each thread
+    const unsigned short NumSourceThreads = SourceTeamSize(NumThreads);
+    if(AnaSourcePar) AnaSourcePar->SetNumThreads(NumSourceThreads);
 
     double* MEAN = new double[DIM];
     double* LENGTH = new double[DIM];
@@ -2998,23 +4046,20 @@ void CATS::SetUpSourceGrid(){
         LENGTH[1] = 2;
     }
 
-    if(BaseSourceGrid){
-        delete BaseSourceGrid; BaseSourceGrid=NULL;
-    }
     if(UseAnalyticSource){
         //for setting up the grid we take the "mean" value of k
         AnaSourcePar->SetVariable(0,(MomBin[0]+MomBin[NumMomBins])*0.5,false);
 //printf("BaseSourceGrid = new CATSelder\n");
 //printf(" AnaSourcePar[3]=%e\n",AnaSourcePar->GetParameter(0));
         BaseSourceGrid = new CATSelder(DIM, GridMinDepth, MAXDEPTH, LIMIT, MEAN, LENGTH,
-                         this, AnaSourcePar, NULL, 0, AutoNormSource);
+                         this, AnaSourcePar, NULL, 0, AutoNormSource, NumSourceThreads, GridQuadrature);
     }
     else if(NumPairs){
         //sorts the whole data according to the GridBoxId (all bins!)
         //this will setup the base grid
         SortAllData();
         BaseSourceGrid = new CATSelder(DIM, GridMinDepth, MAXDEPTH, LIMIT, MEAN, LENGTH,
-                                        NULL, NULL, GridBoxId, NumPairs, AutoNormSource);
+                                        NULL, NULL, GridBoxId, NumPairs, AutoNormSource, NumThreads);
     }
     else{
         BaseSourceGrid = NULL;
@@ -3031,13 +4076,6 @@ void CATS::SetUpSourceGrid(){
         GridBoxId[uPair] -= (int64_t(GridBoxId[uPair])/int64_t(MAXGRIDPTS))*int64_t(MAXGRIDPTS);
     }
 
-    //resets kSourceGrid
-    if(kSourceGrid){
-        for(unsigned uMomBin=0; uMomBin<NumMomBins; uMomBin++){
-            if(kSourceGrid[uMomBin]) delete kSourceGrid[uMomBin];
-        }
-        delete [] kSourceGrid;
-    }
     kSourceGrid = new CATSelder* [NumMomBins];
     for(unsigned uMomBin=0; uMomBin<NumMomBins; uMomBin++){kSourceGrid[uMomBin] = NULL;}
     //sets up kSourceGrid
@@ -3046,11 +4084,11 @@ void CATS::SetUpSourceGrid(){
             break;
         }
         if(UseAnalyticSource){
-            kSourceGrid[uMomBin] = new CATSelder(BaseSourceGrid, this, AnaSourcePar, NULL, 0, AutoNormSource);
+            kSourceGrid[uMomBin] = new CATSelder(BaseSourceGrid, this, AnaSourcePar, NULL, 0, AutoNormSource, NumSourceThreads);
         }
         else if(LoadedPairsPerMomBin[uMomBin]){
             kSourceGrid[uMomBin] = new CATSelder(BaseSourceGrid, NULL, NULL,
-                                                &GridBoxId[ArrayPosition], LoadedPairsPerMomBin[uMomBin], AutoNormSource);
+                                                &GridBoxId[ArrayPosition], LoadedPairsPerMomBin[uMomBin], AutoNormSource, NumThreads);
             ArrayPosition += LoadedPairsPerMomBin[uMomBin];
         }
         else{
@@ -3058,17 +4096,6 @@ void CATS::SetUpSourceGrid(){
         }
     }
 
-    if(kbSourceGrid){
-        for(unsigned uMomBin=0; uMomBin<NumMomBins; uMomBin++){
-            if(!kbSourceGrid[uMomBin]) break;
-            for(unsigned uIpBin=0; uIpBin<NumIpBins; uIpBin++){
-                if(kbSourceGrid[uMomBin][uIpBin]) delete kbSourceGrid[uMomBin][uIpBin];
-            }
-            delete [] kbSourceGrid[uMomBin];
-        }
-        delete [] kbSourceGrid; kbSourceGrid=NULL;
-    }
-
     //sorts the data in k,b blocks and sorts them according to the GridBoxId
     //this is needed only if we use a data source with and more than 1 b-bin
     if(!UseAnalyticSource && NumIpBins>1){
@@ -3094,11 +4121,11 @@ void CATS::SetUpSourceGrid(){
             AnaSourcePar->SetVariable(0,GetMomentum(uMomBin),false);
             for(unsigned uIpBin=0; uIpBin<NumIpBins; uIpBin++){
                 if(UseAnalyticSource){
-                    kbSourceGrid[uMomBin][uIpBin] = new CATSelder(BaseSourceGrid, this, AnaSourcePar, NULL, 0, AutoNormSource);
+                    kbSourceGrid[uMomBin][uIpBin] = new CATSelder(BaseSourceGrid, this, AnaSourcePar, NULL, 0, AutoNormSource, NumSourceThreads);
                 }
                 else if(LoadedPairsPerBin[uMomBin][uIpBin]){
                     kbSourceGrid[uMomBin][uIpBin] = new CATSelder(BaseSourceGrid, NULL, NULL,
-                                                                &GridBoxId[ArrayPosition], LoadedPairsPerBin[uMomBin][uIpBin], AutoNormSource);
+                                                                &GridBoxId[ArrayPosition], LoadedPairsPerBin[uMomBin][uIpBin], AutoNormSource, NumThreads);
                     ArrayPosition += LoadedPairsPerBin[uMomBin][uIpBin];
                 }
                 else{
@@ -3115,6 +4142,12 @@ void CATS::SetUpSourceGrid(){
 }
 
 void CATS::UpdateSourceGrid(){
+    if(UseFixedSourceGrid()){
+        //for a momentum dependent source the values are computed only during the folding
+        if(!MomDepSource) FixedGridSourceError = EvalFixedGridSource((MomBin[0]+MomBin[NumMomBins])*0.5, FixedGridSource);
+        SourceUpdated = true;
+        return;
+    }
     if(BaseSourceGrid) BaseSourceGrid->Update();
     for(unsigned uMomBin=0; uMomBin<NumMomBins; uMomBin++){
         if(kSourceGrid && kSourceGrid[uMomBin]) kSourceGrid[uMomBin]->Update();
@@ -3130,23 +4163,87 @@ void CATS::UpdateSourceGrid(){
     SourceUpdated = true;
 }
 
+bool CATS::UseFixedSourceGrid() const{
+    return FixedGridNumRad && UseAnalyticSource;
+}
+
+bool CATS::FixedSourceGridReady() const{
+    return UseFixedSourceGrid() && NumFixedGridPts && FixedGridTheta==ThetaDependentSource;
+}
+
+void CATS::SetUpFixedSourceGrid(){
+    DelFixedGrid();
+    FixedGridTheta = ThetaDependentSource;
+    const unsigned NumCosTh = ThetaDependentSource?FixedGridNumCosTh:1;
+    NumFixedGridPts = FixedGridNumRad*NumCosTh;
+    FixedGridRad = new double [NumFixedGridPts];
+    FixedGridCosTh = new double [NumFixedGridPts];
+    FixedGridSize = new double [NumFixedGridPts];
+    FixedGridSource = new double [NumFixedGridPts];
+
+    //the same range as for the CATSelder, each point is in the middle of its cell
+    const double DeltaRad = SourceMaxRad*NuToFm/double(FixedGridNumRad);
+    const double DeltaCosTh = 2./double(NumCosTh);
+    for(unsigned uRad=0; uRad<FixedGridNumRad; uRad++){
+        for(unsigned uCosTh=0; uCosTh<NumCosTh; uCosTh++){
+            unsigned uGrid = uRad*NumCosTh+uCosTh;
+            FixedGridRad[uGrid] = (double(uRad)+0.5)*DeltaRad;
+            FixedGridCosTh[uGrid] = ThetaDependentSource?-1.+(double(uCosTh)+0.5)*DeltaCosTh:0;
+            FixedGridSize[uGrid] = ThetaDependentSource?DeltaRad*DeltaCosTh:DeltaRad;
+            FixedGridSource[uGrid] = 0;
+        }
+    }
+    SourceGridReady = true;
+    SourceUpdated = false;
+}
+
+double CATS::EvalFixedGridSource(const double& Momentum, double* Source) const{
+    double Integral=0;
+    AnaSourcePar->SetVariable(0,Momentum,true);
+    EvaluateTheSource(AnaSourcePar, NumFixedGridPts, FixedGridRad, FixedGridCosTh, Source);
+    for(unsigned uGrid=0; uGrid<NumFixedGridPts; uGrid++){
+        Source[uGrid] *= FixedGridSize[uGrid];
+        Integral += Source[uGrid];
+    }
+    if(!AutoNormSource) return 0;
+    //the same as CATSelder::Renormalize
+    double RenormError = Integral?1./Integral:1e64;
+    for(unsigned uGrid=0; uGrid<NumFixedGridPts; uGrid++){
+        Source[uGrid] *= RenormError;
+    }
+    if(RenormError<1) RenormError = RenormError?1./RenormError:1e64;
+    return RenormError-1;
+}
+
 double CATS::CoulombPotential(const double& Radius) const{
     return Gamow?0:Q1Q2*AlphaFS/(fabs(Radius)+1e-64);
 }
 //the differential equation for the Schroedinger equation
 void CATS::PropagatingFunction(double& Basic, double& Full,
                                  const double& Radius, const double& Momentum,
-                                 const unsigned short& usPW, const unsigned short& usCh){
+                                 const unsigned short& usPW, const unsigned short& usCh, double* PotParameters){
     //make sure that there is no division by zero by adding 1e-64
     //the Basic result is the Prop.Fun. WITHOUT a short range potential
 
     Basic = 2*RedMass*CoulombPotential(Radius) + double(usPW)*(double(usPW)+1)/(Radius*Radius+1e-64) - Momentum*Momentum;
     //the Full result is the Prop.Fun. WITH a short range potential
+    //within the tabulated range the spline is used (see TabulatePotentials)
+    if(PotTable && PotTable[ChPwOffset[usCh]+usPW]){
+        const double PosTable = Radius*NuToFm/PotTableStep-1.;
+        if(PosTable>=0 && PosTable<double(PotTableNumRad-1)){
+            const unsigned uRad = PosTable;
+            const double B = PosTable-double(uRad);
+            const double A = 1.-B;
+            const double* T = &PotTable[ChPwOffset[usCh]+usPW][2*uRad];
+            Full = Basic + 2*RedMass*(A*T[0]+B*T[2]+(A*A*A-A)*T[1]+(B*B*B-B)*T[3]);
+            return;
+        }
+    }
     double* Parameters = NULL;
-    if(PotPar[usCh][usPW]){
-        PotPar[usCh][usPW]->SetVariable(0,Radius*NuToFm,true);
-        PotPar[usCh][usPW]->SetVariable(1,Momentum,true);
-        Parameters = PotPar[usCh][usPW]->GetParameters();
+    if(PotParameters){
+        PotParameters[0] = Radius*NuToFm;
+        PotParameters[1] = Momentum;
+        Parameters = PotParameters;
     }
     //else if(PotParArray[usCh][usPW]){
     //    PotParArray[usCh][usPW][0] = Radius*NuToFm;
@@ -3156,15 +4253,6 @@ void CATS::PropagatingFunction(double& Basic, double& Full,
     else{
         return;
     }
-if(DEBUG==omp_get_thread_num())
-{
-printf("  Basic=%.15e\n",Basic);
-printf("  ShortRangePotential[%u][%u]=%.15e\n",usCh,usPW,ShortRangePotential[usCh][usPW](Parameters));
-printf("  Parameters[0]=%.15e\n",Parameters[0]);
-printf("  Parameters[1]=%.15e\n",Parameters[1]);
-printf("  Parameters[2]=%.15e\n",Parameters[2]);
-printf("  Full=%.15e\n",Full);
-}
     //! In principle this should be executed only if ShortRangePotential[usCh][usPW] is defined.
     //! Do note that this function is NEVER called in case this is not true! Make sure that this stays so!
     Full = Basic + 2*RedMass*ShortRangePotential[usCh][usPW](Parameters);
@@ -3207,12 +4295,138 @@ double CATS::ReferencePartialWave(const double& Radius, const double& Momentum,
     //return (Q1Q2&&!Gamow) ? CoulombPartialWave(Radius,Momentum,usPW) : PlanePartialWave(Radius,Momentum,usPW);
 }
 
-double CATS::AsymptoticRatio(const double& Radius, const double& Momentum, const unsigned short& usPW, const int& q1q2) const{
-    return ReferencePartialWave(Radius+CurrentRhoStep/Momentum, Momentum, usPW, q1q2)/(ReferencePartialWave(Radius, Momentum, usPW, q1q2)+1e-64);
+double CATS::AsymptoticRatio(const double& Radius, const double& Momentum, const unsigned short& usPW, const int& q1q2, const double& RhoStep) const{
+    return ReferencePartialWave(Radius+RhoStep/Momentum, Momentum, usPW, q1q2)/(ReferencePartialWave(Radius, Momentum, usPW, q1q2)+1e-64);
 }
 
-double CATS::NewtonRapson(double (CATS::*Function)(const double&, const double&, const unsigned short&, const int&) const,
-                          const double& EpsilonX, const unsigned short& usPW, const double& Momentum, const int& q1q2,
+unsigned short CATS::ReferencePartialWaves(const double& Radius, const double& Momentum, const int& q1q2, const bool& Theta, double* Result) const{
+    const double Rho = Radius*Momentum;
+    if(!Rho){
+        Result[0] = 0;
+        return 1;
+    }
+    const double Eta = RedMass*double(q1q2)*AlphaFS/Momentum;
+    //the partial waves drop quickly for l>Rho, start with a guess for the number of PWs needed and increase it if needed
+    double NumGuess = fabs(Rho)+8;
+    unsigned short NumPw = NumGuess<MaxPw?NumGuess:MaxPw;
+    while(true){
+        //both gsl functions compute all l in a single pass, using the recurrence relations
+        if(q1q2){
+            double Overflow=0;
+            gsl_sf_coulomb_wave_F_array(0, NumPw-1, Eta, fabs(Rho), Result, &Overflow);
+            for(unsigned short usPW=0; usPW<NumPw; usPW++){
+                Result[usPW] /= Momentum;
+                if(Rho<0 && usPW%2==1) Result[usPW] = -Result[usPW];
+            }
+        }
+        else{
+            gsl_sf_bessel_jl_array(NumPw-1, fabs(Rho), Result);
+            for(unsigned short usPW=0; usPW<NumPw; usPW++){
+                Result[usPW] *= (Rho<0 && usPW%2==1)?-Radius:Radius;
+            }
+        }
+        //the same (or a stricter) condition as the one used to stop the summation over the PWs
+        //in EffectiveFunction (Theta==false) or EffectiveFunctionTheta (Theta==true)
+        const double Rad = fabs(Radius)+1e-64;
+        for(unsigned short usPW=1; usPW<NumPw; usPW++){
+            const double OldVal = double(2*usPW-1)*fabs(Result[usPW-1])/Rad;
+            const double Val = double(2*usPW+1)*fabs(Result[usPW])/Rad;
+            if(Theta && OldVal<3.16e-4 && Val<1e-4) return usPW+1;
+            if(!Theta && OldVal*fabs(Result[usPW-1])/Rad<1e-7 && Val*fabs(Result[usPW])/Rad<1e-8) return usPW+1;
+        }
+        if(NumPw==MaxPw) return NumPw;
+        NumPw = 2*NumPw<MaxPw?2*NumPw:MaxPw;
+    }
+}
+
+double CATS::TotWaveFunRadius(const unsigned& uGrid) const{
+    if(UseFixedSourceGrid()) return FixedGridRad[uGrid]*FmToNu;
+    else if(PoorManRenorm!=1 && UseAnalyticSource==false) return BaseSourceGrid->GetGridPtPar(uGrid, 0)*FmToNu*PoorManRenorm;
+    else return BaseSourceGrid->GetGridPtPar(uGrid, 0)*FmToNu;
+}
+
+bool CATS::SetUpRefPartialWaves(const unsigned short& NumThreads){
+    //the tables are reused only if nothing they depend on has changed
+    bool Reuse = RefPartialWave && RefPwNumGridPts==NumGridPts && RefPwQ1Q2==Q1Q2 && RefPwRedMass==RedMass && RefPwMaxPw==MaxPw &&
+                 RefPwTheta==ThetaDependentSource;
+    for(unsigned uGrid=0; uGrid<NumGridPts && Reuse; uGrid++){
+        Reuse = (RefPwRad[uGrid]==TotWaveFunRadius(uGrid));
+    }
+    if(!Reuse){
+        DelRefPartialWaves();
+        RefPartialWave = new double* [NumMomBins];
+        RefPwOffset = new unsigned* [NumMomBins];
+        for(unsigned uMomBin=0; uMomBin<NumMomBins; uMomBin++){
+            RefPartialWave[uMomBin] = NULL;
+            RefPwOffset[uMomBin] = NULL;
+        }
+        RefPwRad = new double [NumGridPts];
+        for(unsigned uGrid=0; uGrid<NumGridPts; uGrid++){
+            RefPwRad[uGrid] = TotWaveFunRadius(uGrid);
+        }
+        RefPwNumGridPts = NumGridPts;
+        RefPwQ1Q2 = Q1Q2;
+        RefPwRedMass = RedMass;
+        RefPwMaxPw = MaxPw;
+        RefPwTheta = ThetaDependentSource;
+    }
+
+    //the tables are computed only for the momentum bins which are evaluated, and as long as they fit in RefPwMaxMemory.
+    //The bins without a table evaluate the reference PWs directly
+    #pragma omp parallel num_threads(NumThreads)
+    {
+    double* Buffer = new double [MaxPw];
+    #pragma omp for
+    for(unsigned uMomBin=0; uMomBin<NumMomBins; uMomBin++){
+        if(MomBinSelected && !MomBinSelected[uMomBin]) continue;
+        if(RefPartialWave[uMomBin]) continue;
+        bool Full;
+        #pragma omp critical(CATS_RefPwMemory)
+        Full = (RefPwMemory>=RefPwMaxMemory);
+        if(Full) continue;
+        const double Momentum = GetMomentum(uMomBin);
+        unsigned Capacity = 16*NumGridPts;
+        double* Table = new double [Capacity];
+        unsigned* Offset = new unsigned [NumGridPts+1];
+        Offset[0] = 0;
+        for(unsigned uGrid=0; uGrid<NumGridPts; uGrid++){
+            const unsigned short NumPw = ReferencePartialWaves(RefPwRad[uGrid], Momentum, Q1Q2, ThetaDependentSource, Buffer);
+            if(Offset[uGrid]+NumPw>Capacity){
+                Capacity = 2*Capacity+NumPw;
+                double* NewTable = new double [Capacity];
+                for(unsigned uEntry=0; uEntry<Offset[uGrid]; uEntry++) NewTable[uEntry] = Table[uEntry];
+                delete [] Table;
+                Table = NewTable;
+            }
+            for(unsigned short usPW=0; usPW<NumPw; usPW++) Table[Offset[uGrid]+usPW] = Buffer[usPW];
+            Offset[uGrid+1] = Offset[uGrid]+NumPw;
+        }
+        const double TableMemory = (double(Capacity)*double(sizeof(double))+double(NumGridPts+1)*double(sizeof(unsigned)))/1048576.;
+        bool Keep;
+        #pragma omp critical(CATS_RefPwMemory)
+        {
+        Keep = (RefPwMemory+TableMemory<=RefPwMaxMemory);
+        if(!Keep && RefPwMemory<RefPwMaxMemory && Notifications>=nWarning)
+            printf("\033[1;33mWARNING:\033[0m The tables of the reference partial waves need more than %g MB, the remaining momentum bins evaluate them directly\n",
+                   RefPwMaxMemory);
+        //no further tables are computed once a table did not fit
+        RefPwMemory = Keep?RefPwMemory+TableMemory:RefPwMaxMemory;
+        }
+        if(!Keep){
+            delete [] Table;
+            delete [] Offset;
+            continue;
+        }
+        RefPartialWave[uMomBin] = Table;
+        RefPwOffset[uMomBin] = Offset;
+    }
+    delete [] Buffer;
+    }
+    return Reuse;
+}
+
+double CATS::NewtonRapson(double (CATS::*Function)(const double&, const double&, const unsigned short&, const int&, const double&) const,
+                          const double& EpsilonX, const unsigned short& usPW, const double& Momentum, const int& q1q2, const double& RhoStep,
                           const double&  xMin, const double&  xMax, const double& fValShift, bool& status) const{
 
     status = true;
@@ -3224,8 +4438,8 @@ double CATS::NewtonRapson(double (CATS::*Function)(const double&, const double&,
     double DeltaF;
 
     for(unsigned iIter=0; iIter<maxIter; iIter++){
-        fVal = (this->*Function)(xVal, Momentum, usPW, q1q2)-fValShift;
-        DeltaF = (this->*Function)(xVal+EpsilonX, Momentum, usPW, q1q2)-fValShift - fVal;
+        fVal = (this->*Function)(xVal, Momentum, usPW, q1q2, RhoStep)-fValShift;
+        DeltaF = (this->*Function)(xVal+EpsilonX, Momentum, usPW, q1q2, RhoStep)-fValShift - fVal;
         if(!DeltaF){
             DeltaX=1;
             if(Notifications>=nWarning)
@@ -3234,12 +4448,12 @@ double CATS::NewtonRapson(double (CATS::*Function)(const double&, const double&,
         else DeltaX = -fVal*EpsilonX/DeltaF;
         xVal += DeltaX;
         int counter = 0;
-        double fValNew = (this->*Function)(xVal, Momentum, usPW, q1q2)-fValShift;
+        double fValNew = (this->*Function)(xVal, Momentum, usPW, q1q2, RhoStep)-fValShift;
         while( ( (fabs(fValNew)>fabs(fVal) && counter<16)
               || (xVal<xMin || xVal>xMax) ) ){
             counter++;
             xVal -= DeltaX*pow(2., -counter);
-            fValNew = (this->*Function)(xVal, Momentum, usPW, q1q2)-fValShift;
+            fValNew = (this->*Function)(xVal, Momentum, usPW, q1q2, RhoStep)-fValShift;
         }
         if(counter==16 && fabs(fValNew)>fabs(fVal)){
             if(Notifications>=nWarning)
@@ -3358,15 +4572,16 @@ complex<double> CATS::EvalWaveFunctionU(const unsigned& uMomBin, const double& R
 
     double MultFactor = DivideByR?1./(Radius+1e-64):1;
 
-    unsigned& SWFB = SavedWaveFunBins[uMomBin][usCh][usPW];
+    const unsigned uWf = WfIndex(uMomBin,usCh,usPW);
+    const unsigned& SWFB = SavedWaveFunBins[uWf];
 
     unsigned RadBin = GetRadBin(Radius, uMomBin, usCh, usPW);
 
     if(RadBin<SWFB && !Asymptotic){
-        const complex<double>* WFU = WaveFunctionU[uMomBin][usCh][usPW];
-        const double* WFR = WaveFunRad[uMomBin][usCh][usPW];
+        const complex<double>* WFU = WaveFunctionU[uWf];
+        const double* WFR = WaveFunRad[uWf];
         //the external WF is assumed to be given in fm
-        complex<double> Result = EvalBinnedFun(Radius, SWFB, WFR, NULL, WFU);
+        complex<double> Result = EvalBinnedFun(Radius, RadBin, SWFB, WFR, NULL, WFU);
         if(Result==1e6 && Notifications>=nWarning)
             printf("\033[1;33mWARNING:\033[0m DeltaRad==0, which might point to a bug! Please contact the developers!\n");
         return Result*MultFactor;
@@ -3380,7 +4595,8 @@ complex<double> CATS::EvalWaveFunctionU(const unsigned& uMomBin, const double& R
     }
 }
 
-double CATS::EffectiveFunction(const unsigned& uMomBin, const double& Radius, const unsigned short& usCh){
+double CATS::EffectiveFunction(const unsigned& uMomBin, const double& Radius, const unsigned short& usCh,
+                               const double* RefPw, const unsigned short& NumRefPw, complex<double>* PwTerms){
     complex<double> Result;
     complex<double> OldResult=100;
     double TotalResult=0;
@@ -3388,6 +4604,7 @@ double CATS::EffectiveFunction(const unsigned& uMomBin, const double& Radius, co
     //here we make the assumption that the individual partial waves are orthogonal to one another!
     //this should be the case in the absence of angular dependence due to the Legendre polynomials
     for(unsigned short usPW=0; usPW<MaxPw; usPW++){
+        if(PwTerms && usPW<NumPW[usCh]) PwTerms[usPW] = 0;
         //wave function symmetrization
         if( IdenticalParticles && (usPW+Spin[usCh])%2 ) continue;
         //numerical solution, no computation result for zero potential
@@ -3398,14 +4615,16 @@ double CATS::EffectiveFunction(const unsigned& uMomBin, const double& Radius, co
             //Check this!!! Should it be squared?
             //the integration of Pl itself results in 1/(2l+1), so this should be fine as it is
             TotalResult += double(2*usPW+1)*pow(abs(Result),2);
+            if(PwTerms) PwTerms[usPW] = double(2*usPW+1)*pow(abs(Result),2);
 //if(OnlyNumPw[usCh])printf("TotalResult=%f\n",TotalResult);
         }
         else if(!OnlyNumPw[usCh]){
-            Result = ReferencePartialWave(Radius, Momentum, usPW, Q1Q2)/(Radius+1e-64);
+            Result = (usPW<NumRefPw?RefPw[usPW]:ReferencePartialWave(Radius, Momentum, usPW, Q1Q2))/(Radius+1e-64);
             //Check this!!! Should it be squared?
             //the integration of Pl itself results in 1/(2l+1), so this should be fine as it is
             Result = double(2*usPW+1)*pow(abs(Result),2);
             TotalResult += abs(Result);
+            if(PwTerms && usPW<NumPW[usCh]) PwTerms[usPW] = abs(Result);
             //convergence criteria
             if(usPW>=NumPW[usCh] && abs(OldResult)<1e-7 && abs(Result)<1e-8) break;
             OldResult = Result;
@@ -3428,45 +4647,42 @@ double CATS::EffectiveFunction(const unsigned& uMomBin, const double& Radius){
 }
 
 double CATS::EffectiveFunctionTheta(const unsigned& uMomBin, const double& Radius, const double& CosTheta, const unsigned short& usCh){
+    double* LegPol = new double [MaxPw];
+    gsl_sf_legendre_Pl_array(MaxPw-1, CosTheta, LegPol);
+    double Result = EffectiveFunctionTheta(uMomBin, Radius, LegPol, usCh);
+    delete [] LegPol;
+    return Result;
+}
+
+//LegPol should contain the Legendre polynomials of all MaxPw partial waves, evaluated at the desired CosTheta.
+//No member variables are modified, i.e. this function is safe to be called in parallel.
+double CATS::EffectiveFunctionTheta(const unsigned& uMomBin, const double& Radius, const double* LegPol, const unsigned short& usCh,
+                                    const double* RefPw, const unsigned short& NumRefPw,
+                                    complex<double>* PwTerms, complex<double>* Amplitude){
     complex<double> Result;
     complex<double> OldResult=100;
     complex<double> TotalResult=0;
     double Momentum = GetMomentum(uMomBin);
 
-    if(!RefPartWave){
-        RefPartWave = new complex<double> [MaxPw];
-        SolvedPartWave = new complex<double> [MaxPw];
-        LegPol = new double [MaxPw];
-    }
-
-    //we set an unrealistic default value to monitor which PW is computed and which not
-    for(unsigned short usPW=0; usPW<MaxPw; usPW++){
-        RefPartWave[usPW] = 1e6;
-        SolvedPartWave[usPW] = 1e6;
-        LegPol[usPW] = 1e6;
-    }
-
     for(unsigned short usPW=0; usPW<MaxPw; usPW++){
         //wave function symmetrization
         if( IdenticalParticles && (usPW+Spin[usCh])%2 ) continue;
         if(usPW<NumPW[usCh] && (ShortRangePotential[usCh][usPW] || ExternalWF[usCh][usPW])){
-            if(LegPol[usPW]==1e6) LegPol[usPW]=gsl_sf_legendre_Pl(usPW,CosTheta);
-            if(SolvedPartWave[usPW]==1e6) SolvedPartWave[usPW]=EvalWaveFunctionU(uMomBin, Radius, usCh, usPW, true);
-            Result = double(2*usPW+1)*SolvedPartWave[usPW]*LegPol[usPW];
+            Result = double(2*usPW+1)*EvalWaveFunctionU(uMomBin, Radius, usCh, usPW, true)*LegPol[usPW];
         }
         else if(!OnlyNumPw[usCh]){
-            if(LegPol[usPW]==1e6) LegPol[usPW]=gsl_sf_legendre_Pl(usPW,CosTheta);
-            if(RefPartWave[usPW]==1e6) RefPartWave[usPW] = ReferencePartialWave(Radius, Momentum, usPW, Q1Q2);
             //please check if a sqrt is needed for 2*l+1. I think not, because above, when we integrate Pl, the integration of Pl itself results in 1/(2l+1)
-            Result = pow(i,usPW)*double(2*usPW+1)*RefPartWave[usPW]/(Radius+1e-64)*LegPol[usPW];
+            Result = pow(i,usPW)*double(2*usPW+1)*(usPW<NumRefPw?RefPw[usPW]:ReferencePartialWave(Radius, Momentum, usPW, Q1Q2))/(Radius+1e-64)*LegPol[usPW];
             if(usPW>=NumPW[usCh] && abs(OldResult)<3.16e-4 && abs(Result)<1e-4) break;
             OldResult = Result;
         }
         else{
             Result = 0;
         }
+        if(PwTerms && usPW<NumPW[usCh]) PwTerms[usPW] = Result;
         TotalResult += Result;
     }
+    if(Amplitude) *Amplitude = TotalResult;
     //!!! There was a factor of x2 missing, no idea from where, could be the angle phi? Check it out!
     return 2.*pow(abs(TotalResult),2);
 }
@@ -3479,6 +4695,55 @@ double CATS::EffectiveFunctionTheta(const unsigned& uMomBin, const double& Radiu
     return TotWF;
 }
 
+//the same expressions as in EffectiveFunction and EffectiveFunctionTheta, which should be kept consistent
+complex<double> CATS::PartialWaveTerm(const unsigned& uMomBin, const double& Radius, const unsigned short& usCh, const unsigned short& usPW,
+                                      const double* LegPol, const double* RefPw, const unsigned short& NumRefPw) const{
+    if( IdenticalParticles && (usPW+Spin[usCh])%2 ) return 0;
+    if(ShortRangePotential[usCh][usPW] || ExternalWF[usCh][usPW]){
+        if(LegPol) return double(2*usPW+1)*EvalWaveFunctionU(uMomBin, Radius, usCh, usPW, true)*LegPol[usPW];
+        return double(2*usPW+1)*pow(abs(EvalWaveFunctionU(uMomBin, Radius, usCh, usPW, true)),2);
+    }
+    if(OnlyNumPw[usCh]) return 0;
+    const double RefWave = (usPW<NumRefPw?RefPw[usPW]:ReferencePartialWave(Radius, GetMomentum(uMomBin), usPW, Q1Q2))/(Radius+1e-64);
+    if(LegPol) return pow(i,usPW)*double(2*usPW+1)*RefWave*LegPol[usPW];
+    return double(2*usPW+1)*pow(RefWave,2);
+}
+
+//called in parallel, each thread for different grid points or momentum bins
+void CATS::UpdateTotWaveFunction(const unsigned& uMomBin, const unsigned short& usCh, const unsigned& uGrid, const double& Radius, const double* LegPol){
+    const unsigned char& Status = WaveFun2Status[uMomBin*NumCh+usCh];
+    if(Status==2) return;
+    //without a table (see SetRefPartialWaveMemory) the reference PWs are evaluated directly
+    const unsigned* Offset = RefPwOffset[uMomBin];
+    const unsigned short NumRefPw = Offset?Offset[uGrid+1]-Offset[uGrid]:0;
+    const double* RefPw = Offset?&RefPartialWave[uMomBin][Offset[uGrid]]:NULL;
+    double& WaveFun2 = WaveFunction2[uMomBin][usCh*NumGridPts+uGrid];
+    complex<double>* Terms = PwTerm?&PwTerm[uMomBin][uGrid*NumChPw+ChPwOffset[usCh]]:NULL;
+    complex<double>* Amplitude = (LegPol&&PwAmplitude)?&PwAmplitude[uMomBin][usCh*NumGridPts+uGrid]:NULL;
+
+    //only the contributions of the changed PWs are replaced
+    if(Status==1 && Terms && (!LegPol||Amplitude)){
+        complex<double> Change = 0;
+        for(unsigned short usPW=0; usPW<NumPW[usCh]; usPW++){
+            if(PwTermValid[WfIndex(uMomBin,usCh,usPW)]) continue;
+            const complex<double> NewTerm = PartialWaveTerm(uMomBin, Radius, usCh, usPW, LegPol, RefPw, NumRefPw);
+            Change += NewTerm-Terms[usPW];
+            Terms[usPW] = NewTerm;
+        }
+        if(LegPol){
+            *Amplitude += Change;
+            WaveFun2 = 2.*pow(abs(*Amplitude),2);
+        }
+        else{
+            WaveFun2 += real(Change)*(1+IdenticalParticles);
+        }
+        return;
+    }
+
+    if(LegPol) WaveFun2 = EffectiveFunctionTheta(uMomBin, Radius, LegPol, usCh, RefPw, NumRefPw, Terms, Amplitude);
+    else WaveFun2 = EffectiveFunction(uMomBin, Radius, usCh, RefPw, NumRefPw, Terms);
+}
+
 unsigned CATS::GetBin(const double& Value, const double* Range, const unsigned& NumBins) const{
     if(NumBins<=1) return 0;
     unsigned WhichBin=NumBins/2;
@@ -3507,14 +4772,96 @@ unsigned CATS::GetBin(const double& Value, const double* Range, const unsigned&
 }
 
 unsigned CATS::GetMomBin(const double& Momentum) const{
-    return GetBin(Momentum, MomBin, NumMomBins+1);
+    return GetUniformBin(Momentum, MomBin, NumMomBins, MomBinInvStep, MomBinLogScale);
 }
 unsigned CATS::GetIpBin(const double& bVal) const{
-    return GetBin(bVal, IpBin, NumIpBins+1);
+    return GetUniformBin(bVal, IpBin, NumIpBins, IpBinInvStep, IpBinLogScale);
 }
 unsigned CATS::GetRadBin(const double& Radius, const unsigned& uMomBin,
                          const unsigned short& usCh, const unsigned short& usPW) const{
-    return GetBin(Radius, WaveFunRad[uMomBin][usCh][usPW], SavedWaveFunBins[uMomBin][usCh][usPW]+1);
+    const unsigned uWf = WfIndex(uMomBin,usCh,usPW);
+    const unsigned& SWFB = SavedWaveFunBins[uWf];
+    const double* WFR = WaveFunRad[uWf];
+    //the same output as GetBin(Radius, WFR, SWFB+1)
+    if(!SWFB) return 0;
+    if(Radius<WFR[0]) return SWFB+1;
+    if(Radius>WFR[SWFB]) return SWFB+2;
+    const unsigned& UniBin = WaveFunUniBin[uWf];
+    if(UniBin<SWFB && Radius>=WFR[UniBin]){
+        unsigned RadBin = UniBin+unsigned((Radius-WFR[UniBin])/WaveFunUniStep[uWf]);
+        if(RadBin>=SWFB) RadBin = SWFB-1;
+        //corrects for the numerical rounding
+        while(RadBin>UniBin && Radius<WFR[RadBin]) RadBin--;
+        while(RadBin+1<SWFB && Radius>WFR[RadBin+1]) RadBin++;
+        return RadBin;
+    }
+    return GetBin(Radius, WFR, UniBin+1);
+}
+
+unsigned CATS::WfIndex(const unsigned& uMomBin, const unsigned short& usCh, const unsigned short& usPW) const{
+    return uMomBin*NumChPw+ChPwOffset[usCh]+usPW;
+}
+
+void CATS::ReserveWaveFunction(const unsigned& uWf, const unsigned& NumRadBins){
+    SavedWaveFunBins[uWf] = NumRadBins;
+    WaveFunUniBin[uWf] = NumRadBins;
+    if(NumRadBins<=WaveFunCapacity[uWf]) return;
+    if(WaveFunRad[uWf]) delete [] WaveFunRad[uWf];
+    if(WaveFunctionU[uWf]) delete [] WaveFunctionU[uWf];
+    //some extra space, as the number of points changes slightly with the parameters of the potential
+    WaveFunCapacity[uWf] = NumRadBins+NumRadBins/8;
+    WaveFunRad[uWf] = new double [WaveFunCapacity[uWf]+1];
+    WaveFunctionU[uWf] = new complex<double> [WaveFunCapacity[uWf]];
+}
+
+void CATS::SetUniformRadBins(const unsigned& uWf){
+    const unsigned& SWFB = SavedWaveFunBins[uWf];
+    const double* WFR = WaveFunRad[uWf];
+    unsigned& UniBin = WaveFunUniBin[uWf];
+    UniBin = SWFB;
+    WaveFunUniStep[uWf] = 0;
+    if(!SWFB) return;
+    const double LastStep = WFR[SWFB]-WFR[SWFB-1];
+    if(LastStep<=0) return;
+    UniBin = SWFB-1;
+    while(UniBin && fabs(WFR[UniBin]-WFR[UniBin-1]-LastStep)<1e-6*LastStep) UniBin--;
+    WaveFunUniStep[uWf] = (WFR[SWFB]-WFR[UniBin])/double(SWFB-UniBin);
+}
+
+double CATS::UniformBinStep(const double* Bins, const unsigned& NumBins, bool& LogScale) const{
+    LogScale = false;
+    if(!Bins || NumBins<2) return 0;
+    //the bins are compared with the mean bin width, the tolerance accounts for the numerical rounding
+    const double Step = (Bins[NumBins]-Bins[0])/double(NumBins);
+    bool Uniform = Step>0;
+    for(unsigned uBin=0; uBin<NumBins && Uniform; uBin++){
+        Uniform = fabs(Bins[uBin+1]-Bins[uBin]-Step)<=1e-9*Step;
+    }
+    if(Uniform) return 1./Step;
+    if(Bins[0]<=0) return 0;
+    const double LogStep = log(Bins[NumBins]/Bins[0])/double(NumBins);
+    Uniform = LogStep>0;
+    for(unsigned uBin=0; uBin<NumBins && Uniform; uBin++){
+        Uniform = fabs(log(Bins[uBin+1]/Bins[uBin])-LogStep)<=1e-9*LogStep;
+    }
+    if(!Uniform) return 0;
+    LogScale = true;
+    return 1./LogStep;
+}
+
+unsigned CATS::GetUniformBin(const double& Value, const double* Bins, const unsigned& NumBins,
+                             const double& InvStep, const bool& LogScale) const{
+    if(!InvStep) return GetBin(Value, Bins, NumBins+1);
+    if(Value<Bins[0]) return NumBins+1;
+    if(Value>Bins[NumBins]) return NumBins+2;
+    unsigned WhichBin = unsigned((LogScale?log(Value/Bins[0]):Value-Bins[0])*InvStep);
+    if(WhichBin>=NumBins) WhichBin = NumBins-1;
+    //corrects for the numerical rounding
+    if(WhichBin && Value<Bins[WhichBin]) WhichBin--;
+    else if(WhichBin+1<NumBins && Value>Bins[WhichBin+1]) WhichBin++;
+    if(Bins[WhichBin]<Value && Value<Bins[WhichBin+1]) return WhichBin;
+    //a value at the bin edge is assigned in the same way as in GetBin
+    return GetBin(Value, Bins, NumBins+1);
 }
 
 template <class Type> Type CATS::GetBinCenter(const Type* Bins, const unsigned& WhichBin) const{
@@ -3524,8 +4871,11 @@ template <class Type> Type CATS::GetBinCenter(const Type* Bins, const unsigned&
 template <class Type> Type CATS::EvalBinnedFun(const double& xVal, const unsigned& NumBins, const double* Bins, const double* BinCent, const Type* Function) const{
     if(xVal<Bins[0] || xVal>Bins[NumBins]) return 0;
     if(NumBins==1) return Function[0];
-    unsigned WhichBin = GetBin(xVal,Bins,NumBins+1);
+    return EvalBinnedFun(xVal, GetBin(xVal,Bins,NumBins+1), NumBins, Bins, BinCent, Function);
+}
 
+template <class Type> Type CATS::EvalBinnedFun(const double& xVal, const unsigned& WhichBin, const unsigned& NumBins, const double* Bins, const double* BinCent, const Type* Function) const{
+    if(NumBins==1) return Function[0];
     double Value[3];
     if(BinCent){
         Value[0] = WhichBin?BinCent[WhichBin-1]:-1;
@@ -3641,6 +4991,30 @@ double CATS::EvaluateTheSource(const double& Momentum, const double& Radius, con
 //printf("test\n");
     return CatsSourceForwarder(SourceContext,AnaSourcePar->GetParameters());
 }
+void CATS::EvaluateTheSource(CATSparameters* Pars, const unsigned& NumPts, const double* Radius, const double* CosTheta, double* Result) const{
+    if( (!AnalyticSource && !ForwardedSource) || (AnalyticSource && ForwardedSource) || !Pars || (ForwardedSource && !SourceContext) ){
+        if(Notifications>=nError){
+            printf("\033[1;31mERROR:\033[0m EvaluateTheSource reported a crash! The source is not (uniquely) defined!\n");
+        }
+        for(unsigned uPt=0; uPt<NumPts; uPt++) Result[uPt] = 0;
+        return;
+    }
+    double* Parameters = Pars->GetParameters();
+    if(ForwardedSource){
+        CatsSourceBatchForwarder(SourceContext,Parameters,NumPts,Radius,CosTheta,Result);
+    }
+    else if(AnalyticSourceBatch){
+        AnalyticSourceBatch(Parameters,NumPts,Radius,CosTheta,Result);
+    }
+    else{
+        //the variables of the current thread are set directly
+        for(unsigned uPt=0; uPt<NumPts; uPt++){
+            Parameters[1] = Radius[uPt];
+            if(CosTheta) Parameters[2] = CosTheta[uPt];
+            Result[uPt] = AnalyticSource(Parameters);
+        }
+    }
+}
 
 
 unsigned CATS::GetNumSourcePars() const{
@@ -3672,11 +5046,39 @@ double CATS::EvaluateThePotential(const unsigned short& usCh, const unsigned sho
     if(!ShortRangePotential[usCh][usPW]){
         return 0;
     }
+    //a potential without parameters gets only the variables (radius and momentum)
+    if(!PotPar[usCh][usPW]){
+        double Variables[CATSparameters::tPotential] = {Radius,Momentum};
+        return ShortRangePotential[usCh][usPW](Variables);
+    }
     PotPar[usCh][usPW]->SetVariable(0,Radius,true);
     PotPar[usCh][usPW]->SetVariable(1,Momentum,true);
     double* Parameters =  PotPar[usCh][usPW]->GetParameters();
     return ShortRangePotential[usCh][usPW](Parameters);
 }
+void CATS::EvaluateThePotential(const unsigned short& usCh, const unsigned short& usPW, const double& Momentum,
+                                const unsigned& NumPts, const double* Radius, double* Result) const{
+    if(!ShortRangePotential || usCh>=NumCh || usPW>=NumPW[usCh] || !ShortRangePotential[usCh] || !ShortRangePotential[usCh][usPW]){
+        if(ShortRangePotential && (usCh>=NumCh || usPW>=NumPW[usCh]) && Notifications>=nError)
+            printf("\033[1;31mERROR:\033[0m Bad input in CATS::EvaluateThePotential(...)\n");
+        for(unsigned uPt=0; uPt<NumPts; uPt++) Result[uPt] = 0;
+        return;
+    }
+    double Variables[CATSparameters::tPotential] = {0,Momentum};
+    double* Parameters = Variables;
+    if(PotPar[usCh][usPW]){
+        PotPar[usCh][usPW]->SetVariable(1,Momentum,true);
+        Parameters = PotPar[usCh][usPW]->GetParameters();
+    }
+    if(ShortRangePotentialBatch[usCh][usPW]){
+        ShortRangePotentialBatch[usCh][usPW](Parameters,NumPts,Radius,Result);
+        return;
+    }
+    for(unsigned uPt=0; uPt<NumPts; uPt++){
+        Parameters[0] = Radius[uPt];
+        Result[uPt] = ShortRangePotential[usCh][usPW](Parameters);
+    }
+}
 double CATS::EvaluateCoulombPotential(const double& Radius) const{
     if(Q1Q2==0){
         return 0;
@@ -3701,6 +5103,7 @@ unsigned CATS::GetNumPotPars(const unsigned short& usCh, const unsigned short& u
 }
 
 CATSelder* CATS::GetTheElder(const double& Momentum){
+    if(!kSourceGrid) return NULL;
     return kSourceGrid[MomDepSource?GetMomBin(Momentum):0];
 }
 
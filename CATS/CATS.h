@@ -40,6 +40,12 @@ using namespace std;
 //this typedef it used to save the potentials for the
 //different channels as an array of function pointers.
 typedef double (*CatsPotential)(double*);
+//optional batch versions of the potential and the analytic source, evaluating NumPts radii (fm) at once.
+//Pars is the same array as for the scalar function, the variables of which ([0] radius for the potential,
+//[1] radius and [2] cosθ for the source) are ignored. The CosTheta can be NULL, in which case Pars[2] is used.
+//The output of a batch function should be identical to that of the corresponding scalar function
+typedef void (*CatsPotentialBatch)(double* Pars, const unsigned& NumPts, const double* Radius, double* Result);
+typedef void (*CatsSourceBatch)(double* Pars, const unsigned& NumPts, const double* Radius, const double* CosTheta, double* Result);
 
 //assumptions: the potential is radial-symmetric.
 //internally only Gaussian natural units (in MeV !!!) are used,
@@ -122,8 +128,14 @@ public:
     void SetOnlyNumericalPw(const unsigned short& usCh, const bool& val);
     bool GetOnlyNumericalPw(const unsigned short& usCh) const;
 
+    //the max. number of threads (0 = all cores) of the own execution context of this object
+    //N.B. has no effect while an external execution context is used (see SetExecution), a warning is printed in that case
     void SetMaxNumThreads(const unsigned short& maxnumthreads);
     unsigned short GetMaxNumThreads() const;
+    //use an external execution context (not owned by CATS), e.g. one shared between several CATS objects.
+    //NULL restores the own execution context
+    void SetExecution(CATSexecution* execution);
+    CATSexecution* GetExecution() const;
 
     void SetMaxRho(const double& maxrho);
     double GetMaxRho() const;
@@ -131,6 +143,47 @@ public:
     void SetExcludeFailedBins(const bool& efb);
     bool GetExcludeFailedBins() const;
 
+    //if set, the solutions of the Schroedinger equation are saved to (and loaded from) files in this folder.
+    //A file is identified by all input of the Schroedinger solver (reduced mass, charge, momentum bins, channels and
+    //partial waves, the potentials and their parameters, numerical settings). An empty string switches the cache off.
+    //N.B. the potentials are identified by their values evaluated at 32 radii and 3 momenta, not by name. Two different potentials
+    //that agree at these points would share the same file, use a different PotentialId for each potential (or set of potentials) to avoid that.
+    void SetWaveFunctionCache(const char* folder, const unsigned& PotentialId=0);
+    void GetWaveFunctionCache(char* folder) const;
+    unsigned GetWaveFunctionCacheId() const;
+
+    //if positive, the momentum bins are evaluated adaptively: the Schroedinger equation is solved only for a coarse subset
+    //of the bins, which is refined until the linear interpolation between the solved bins reproduces the correlation function
+    //and the phase shifts within this tolerance. The remaining bins are filled by linear interpolation.
+    //N.B. the wave functions are available only for the solved bins (see GetMomBinSolved). Zero (default) switches this off.
+    void SetAdaptiveMomBins(const double& tolerance);
+    double GetAdaptiveMomBins() const;
+    //true if the Schroedinger equation was solved for this bin, i.e. its wave function is available
+    bool GetMomBinSolved(const unsigned& WhichMomBin) const;
+
+    //if positive, the contribution of each numerically solved PW to the total wave function is saved. After a change of the potential
+    //of a single PW (e.g. during a fit), only its contribution is replaced instead of evaluating the sum over all PWs.
+    //This needs 16 bytes per momentum bin, grid point and PW (plus one channel for an angular dependent source), if more
+    //than MaxMemoryMB are needed the option is switched off. Zero (default) switches this off.
+    //N.B. independently of this option, the total wave function is reevaluated only for the channels that have changed
+    void SetIncrementalTotWaveFun(const double& MaxMemoryMB);
+    double GetIncrementalTotWaveFun() const;
+
+    //if positive, the short range potentials are tabulated (once per parameter set) at NumRad equidistant radii up to MaxRad,
+    //and evaluated with a cubic spline while solving the Schroedinger equation. This pays off for expensive potentials (e.g. AV18).
+    //N.B. the potentials should not depend on the momentum. Outside of the table the potential is evaluated directly.
+    //The spline is checked against the potential (evaluated at the largest momentum) in between the tabulated radii,
+    //if the deviation exceeds Tolerance*max|V| the potential of this PW is always evaluated directly.
+    //Zero (default) switches this off. A few thousand points are typically needed.
+    void SetTabulatedPotential(const unsigned& NumRad, const double& Tolerance=1e-4);
+    unsigned GetTabulatedPotential() const;
+
+    //the reference (plane or Coulomb) partial waves, needed for the total wave function, are tabulated for each momentum bin
+    //at the radii of the grid and reused until the grid changes. This needs 8 bytes per momentum bin, grid point and reference PW,
+    //the momentum bins that do not fit within MaxMemoryMB (default 256) evaluate them directly. Zero switches the tables off.
+    void SetRefPartialWaveMemory(const double& MaxMemoryMB);
+    double GetRefPartialWaveMemory() const;
+
     void SetMaxGridDepth(const short& mgd);
     short GetMaxGridDepth() const;
     void SetSourceMinValOnGrid(const double& smvg);
@@ -144,6 +197,19 @@ public:
     short GetGridManDepth() const;
     void SetGridEpsilon(const double& val);
     double GetGridEpsilon() const;
+    //for an analytic source, the number of Gauss-Legendre points (per dimension) used to integrate the source within each cell
+    //of the grid. Both the refinement of the grid and the evaluation of the correlation function are based on these points,
+    //which reach the same precision with a much coarser grid (see SetGridEpsilon and SetGridMaxDepth). 1 (default) is the midpoint rule.
+    void SetGridQuadrature(const unsigned short& order);
+    unsigned short GetGridQuadrature() const;
+
+    //if numrad>0, an analytic source is integrated on a fixed grid with numrad equidistant points in r (and numcosth in cos(theta),
+    //for an angular dependent source) instead of the adaptive CATSelder grid. |psi|^2 is tabulated on this grid only once,
+    //thus changing the source (e.g. during a fit of the source size) requires only a weighted sum for each momentum bin.
+    //N.B. the source is evaluated in parallel for the different momentum bins. For a source that does not depend on k
+    //use SetMomentumDependentSource(false), in which case it is evaluated only once.
+    void SetFixedSourceGrid(const unsigned& numrad, const unsigned& numcosth=1);
+    unsigned GetFixedSourceGrid() const;
 
     void SetMomentumDependentSource(const bool& val);
 
@@ -267,8 +333,14 @@ public:
                        const unsigned short& usCh, const unsigned short& usPW) const;
     double EvaluateTheSource(CATSparameters* Pars) const;
     double EvaluateTheSource(const double& Momentum, const double& Radius, const double& CosTheta) const;
+    //evaluates the source at NumPts radii (and cosθ, can be NULL) for the momentum and parameters saved in Pars.
+    //Uses the batch source if defined, otherwise the scalar source is called for each point
+    void EvaluateTheSource(CATSparameters* Pars, const unsigned& NumPts, const double* Radius, const double* CosTheta, double* Result) const;
     unsigned GetNumSourcePars() const;
     double EvaluateThePotential(const unsigned short& usCh, const unsigned short& usPW, const double& Momentum, const double& Radius) const;
+    //the same for NumPts radii (fm), using the batch potential if defined
+    void EvaluateThePotential(const unsigned short& usCh, const unsigned short& usPW, const double& Momentum,
+                              const unsigned& NumPts, const double* Radius, double* Result) const;
     double EvaluateCoulombPotential(const double& Radius) const;
     unsigned GetNumPotPars(const unsigned short& usCh, const unsigned short& usPW) const;
     CATSelder* GetTheElder(const double& Momentum);
@@ -289,6 +361,9 @@ public:
     //has no information of the length of this array, it is the responsibility of the user to make source there is
     //no segmentation violation!!!
     void SetShortRangePotential(const unsigned& usCh, const unsigned& usPW, const unsigned& WhichPar, const double& Value);
+    //an optional batch version of the potential of usCh,usPW, used whenever CATS needs the potential at many radii.
+    //Should be set after SetShortRangePotential, which resets it. NULL switches back to the scalar potential
+    void SetShortRangePotentialBatch(const unsigned& usCh, const unsigned& usPW, CatsPotentialBatch potbatch);
 
     void RemoveAnaSource();
 
@@ -302,6 +377,16 @@ public:
     //2) define a source function as double SOURCE(double (*fptr)(void*, double*), void* context, double* Pars){return fptr(context,Pars);}
     //3) pass to your CATS object the source by calling .SetAnaSource(FORWARDER,OBJ);
     void SetAnaSource(double (*FS)(void*, double*), void* context, const unsigned& numparameters=0);
+    //an optional batch version of the analytic source (not needed for a forwarded source, see CatsSource::EvalBatch),
+    //used when the source is evaluated on the grid. Should be set after SetAnaSource, which resets it
+    void SetAnaSourceBatch(CatsSourceBatch ASB);
+    //if true, the forwarded source (i.e. the object behind the context) may be evaluated by several threads at once.
+    //By default (false) it is evaluated by a single thread, as most objects modify themselves in Eval (initialization, caches etc.).
+    //N.B. a source function (SetAnaSource(double (*AS)(double*),...)) has to be thread safe in any case
+    void SetThreadSafeSource(const bool& threadsafe);
+    bool GetThreadSafeSource() const;
+    //the object behind a forwarded source, NULL for a source function
+    void* GetSourceContext() const;
     //void SetAnaSource(const CatsSource& SOURCE);
 /*
 ///////////////////////////////////////////////////////////////////////////////////////////
@@ -431,12 +516,18 @@ protected:
     unsigned NumMomBins;
     double* MomBin;
     double* MomBinCenter;
+    //the inverse bin width if the momentum bins are equidistant (in log(k) if MomBinLogScale), else zero (see UniformBinStep)
+    double MomBinInvStep;
+    bool MomBinLogScale;
     double* ChannelWeight;
 
     unsigned NumIpBins;
     double* IpBin;
+    //the same for the b-bins
+    double IpBinInvStep;
+    bool IpBinLogScale;
 
-    //this guy should only be modified in ComputeTotWaveFunction, else the WaveFunction2 memory management will fail
+    //this guy should only be modified in ComputeTotWaveFunction, else the WaveFunction2 indexing will fail
     unsigned NumGridPts;
 
     //the very first radius to be computed. Related with the shape of the potential. As a rule of thumb,
@@ -466,7 +557,10 @@ protected:
     //the max. 'l' to be computed by CATS
     unsigned short MaxPw;
     bool* OnlyNumPw;
-    unsigned short MaxNumThreads;
+    //the own execution context, used unless an external one is set
+    CATSexecution* OwnExecution;
+    //the execution context deciding on the number of threads in all parallel regions
+    CATSexecution* Execution;
 
     bool ExcludeFailedConvergence;
     bool MomDepSource;
@@ -477,8 +571,15 @@ protected:
     short GridMaxDepth;
     //0 = default value (1/1024 for 1D grid, 1/8192 for 2D grid), max value is 0.125
     double GridEpsilon;
+    unsigned short GridQuadrature;
 
     char* InputFileName;
+    char* WaveFunctionCache;
+    unsigned WaveFunctionCacheId;
+    double AdaptiveMomBins;
+    double IncrementalTotWaveFun;
+    unsigned PotTableNumRad;
+    double PotTableTolerance;
     //total number of selected pairs
     unsigned NumPairs;
     //percentage of selected same event pairs with a specific impact parameter
@@ -508,8 +609,25 @@ protected:
     //in bins of momentum/ImpactParameter
     CATSelder*** kbSourceGrid;
 
+    //the fixed source grid, see SetFixedSourceGrid
+    unsigned FixedGridNumRad;
+    unsigned FixedGridNumCosTh;
+    //the number of points of the fixed grid that is set up (zero if not)
+    unsigned NumFixedGridPts;
+    //the value of ThetaDependentSource with which the fixed grid was set up
+    bool FixedGridTheta;
+    //the r (in fm), cos(theta) and cell size of each point, ordered in r
+    double* FixedGridRad;
+    double* FixedGridCosTh;
+    double* FixedGridSize;
+    //the source on the fixed grid, used for a source that does not depend on k
+    double* FixedGridSource;
+    double FixedGridSourceError;
+
     bool LoadedData;//i.e. the data-file was read
     bool SourceGridReady;//i.e. the Particle container is set up properly
+    //only the source (function or parameters) has changed since the last KillTheCat, i.e. the fixed grid can be kept
+    bool SourceFunChanged;
     bool SourceUpdated;
     bool ComputedWaveFunction;
     bool ComputedCorrFunction;
@@ -528,13 +646,19 @@ protected:
     //!THE INPUT FOR THE POTENTIAL IS ASSUMED TO BE IN [fm]
     //!THE OUTPUT SHOULD BE IN [MeV]
     CatsPotential** ShortRangePotential;
+    //the batch versions, NULL if not defined
+    CatsPotentialBatch** ShortRangePotentialBatch;
 
     double CoulombPotential(const double& Radius) const;
 
     //input vars: [0] should always be the momentum, [1] the radius and [2] 'cosθ'
     double (*AnalyticSource)(double*);
+    CatsSourceBatch AnalyticSourceBatch;
     double (*ForwardedSource)(void*, double*);
     void* SourceContext;
+    bool ThreadSafeSource;
+    //the number of threads that may evaluate the source at once (1 for a forwarded source which is not thread safe)
+    unsigned short SourceTeamSize(const unsigned short& NumThreads) const;
     //CatsSource* MemberSource;
 
 
@@ -554,7 +678,6 @@ protected:
 
     //!Any other variables or functions used at runtime internally by CATS
 
-    double CurrentRhoStep;
     //!------------------------------------------------
 
     //!Constants
@@ -564,18 +687,43 @@ protected:
 
     //!Functions used internally by CATS
     //the differential equation for the Schroedinger equation
+    //PotParameters are the parameters of the potential for the current thread (NULL if there is no potential)
     void PropagatingFunction(double& Basic, double& Full,
                                const double& Radius, const double& Momentum,
-                               const unsigned short& AzQN, const unsigned short& Pol);
+                               const unsigned short& AzQN, const unsigned short& Pol, double* PotParameters);
 
     void ComputeWaveFunction();
+    //the key identifying the current input of ComputeWaveFunction, returns its length. Key can be NULL
+    unsigned WaveFunctionCacheKey(double* Key);
+    void WaveFunctionCacheFile(const double* Key, const unsigned& KeyLength, char* FileName) const;
+    //returns true if the wave functions were successfully loaded from the cache
+    bool LoadWaveFunctionCache();
+    void SaveWaveFunctionCache();
     void ComputeTotWaveFunction(const bool& ReallocateTotWaveFun);
+    //solves, evaluates and folds only a subset of the momentum bins, which are refined until the AdaptiveMomBins tolerance is met
+    void ComputeAdaptiveMomBins(const bool& TotWaveFunEvaluated, const bool& ReallocateTotWaveFun);
     short LoadData(const unsigned short& NumBlankHeaderLines=3);
     unsigned LoadDataBuffer(const unsigned& WhichIpBin, CatsDataBuffer* KittyBuffer);
     void FoldSourceAndWF();
     void SortAllData();
     void SetUpSourceGrid();
     void UpdateSourceGrid();
+    bool UseFixedSourceGrid() const;
+    //true if the fixed source grid is used and it is already set up
+    bool FixedSourceGridReady() const;
+    void SetUpFixedSourceGrid();
+    //saves the source at each point of the fixed grid in Source, returns the error due to the renormalization
+    double EvalFixedGridSource(const double& Momentum, double* Source) const;
+    //the final correction of the correlation function, based on the integral of the source (SourceInt) and the part
+    //of it within the SourceMinRad-SourceMaxRad range (SourceIntCut)
+    void NormalizeCorrFun(double& CorrFun, double& CorrFunErr, double SourceInt, double SourceIntCut) const;
+    //copies the values and errors of the source on a CATSelder grid into contiguous arrays
+    void FlattenSourceGrid(CATSelder* Grid, const unsigned& NumPts, double* Source, double* SourceErr) const;
+    //the sums over all grid points of Source (SourceInt), and over the points InRange of Source (SourceIntCut),
+    //Source*WaveFun (CorrFun) and (Source*WaveFun*SourceErr)^2 (CorrFunErr). InRange should be 0 or 1.
+    //Points out of range or with a zero source do not contribute to CorrFun, even if WaveFun is not finite there.
+    void FoldKernel(const unsigned& NumPts, const double* Source, const double* SourceErr, const double* InRange,
+                    const double* WaveFun, double& SourceInt, double& SourceIntCut, double& CorrFun, double& CorrFunErr) const;
 
     float ProgressCompute;
     float ProgressLoad;
@@ -588,11 +736,17 @@ protected:
     //radial/coulomb partial wave as a solution from the gsl libraries
     double ReferencePartialWave(const double& Radius, const double& Momentum, const unsigned short& usPW, const int& q1q2) const;
 
-    double AsymptoticRatio(const double& Radius, const double& Momentum, const unsigned short& usPW, const int& q1q2) const;
+    //all reference partial waves from l=0, until the point where they are small enough to stop the summation
+    //over l in EffectiveFunction (or EffectiveFunctionTheta if Theta==true).
+    //Returns the number of evaluated PWs, Result should have a size of at least MaxPw
+    unsigned short ReferencePartialWaves(const double& Radius, const double& Momentum, const int& q1q2, const bool& Theta, double* Result) const;
+
+    //the RhoStep is passed as an argument (and not saved as a member), as this function is evaluated by many threads in parallel
+    double AsymptoticRatio(const double& Radius, const double& Momentum, const unsigned short& usPW, const int& q1q2, const double& RhoStep) const;
 
     //a numerical root-finder. Very fast and accurate for well-behaved (near to linear) functions
-    double NewtonRapson(double (CATS::*Function)(const double&, const double&, const unsigned short&, const int&) const,
-                        const double& EpsilonX, const unsigned short& usPW, const double& Momentum, const int& q1q2,
+    double NewtonRapson(double (CATS::*Function)(const double&, const double&, const unsigned short&, const int&, const double&) const,
+                        const double& EpsilonX, const unsigned short& usPW, const double& Momentum, const int& q1q2, const double& RhoStep,
                           const double&  xMin, const double&  xMax, const double& fValShift, bool& status) const;
 
     template <class Type> void ResortData(Type* input, DLM_Sort <int64_t, unsigned>& Sorter);
@@ -604,14 +758,42 @@ protected:
     //N.B. The result would differ from EvalWaveFunctionU/Radius due to the extrapolation done.
     complex<double> EvalWaveFunctionU(const unsigned& uMomBin, const double& Radius,
                              const unsigned short& usCh, const unsigned short& usPW, const bool& DivideByR, const bool& Asymptotic=false) const;
-    double EffectiveFunction(const unsigned& uMomBin, const double& Radius, const unsigned short& usCh);
+    //RefPw (if available) are the first NumRefPw reference partial waves at this Radius and momentum.
+    //If PwTerms is set, the contribution of each of the NumPW[usCh] PWs is saved in it (see PartialWaveTerm)
+    double EffectiveFunction(const unsigned& uMomBin, const double& Radius, const unsigned short& usCh,
+                             const double* RefPw=NULL, const unsigned short& NumRefPw=0, complex<double>* PwTerms=NULL);
     double EffectiveFunction(const unsigned& uMomBin, const double& Radius);
 
     double EffectiveFunctionTheta(const unsigned& uMomBin, const double& Radius, const double& CosTheta, const unsigned short& usCh);
+    //same as above, but with the Legendre polynomials (for all MaxPw) already evaluated at CosTheta.
+    //If set, the amplitude of each of the NumPW[usCh] PWs is saved in PwTerms, and their sum in Amplitude
+    double EffectiveFunctionTheta(const unsigned& uMomBin, const double& Radius, const double* LegPol, const unsigned short& usCh,
+                                  const double* RefPw=NULL, const unsigned short& NumRefPw=0,
+                                  complex<double>* PwTerms=NULL, complex<double>* Amplitude=NULL);
     double EffectiveFunctionTheta(const unsigned& uMomBin, const double& Radius, const double& CosTheta);
+    //the contribution of a single PW (usPW<NumPW[usCh]) to EffectiveFunction, or to the amplitude in EffectiveFunctionTheta if LegPol is set
+    complex<double> PartialWaveTerm(const unsigned& uMomBin, const double& Radius, const unsigned short& usCh, const unsigned short& usPW,
+                                    const double* LegPol, const double* RefPw, const unsigned short& NumRefPw) const;
+    //evaluates WaveFunction2 at a single grid point, depending on WaveFun2Status either fully or by replacing the contributions
+    //of the changed PWs. LegPol should be NULL for a source that does not depend on theta.
+    void UpdateTotWaveFunction(const unsigned& uMomBin, const unsigned short& usCh, const unsigned& uGrid, const double& Radius, const double* LegPol);
+
+    //the index of the radial wave function of a given mom/pol/pw, used for SavedWaveFunBins, WaveFunRad etc.
+    unsigned WfIndex(const unsigned& uMomBin, const unsigned short& usCh, const unsigned short& usPW) const;
+    //sets SavedWaveFunBins, making sure that WaveFunRad and WaveFunctionU have enough memory for NumRadBins
+    void ReserveWaveFunction(const unsigned& uWf, const unsigned& NumRadBins);
+    //should be called after WaveFunRad is set, finds the range of equidistant bins used by GetRadBin
+    void SetUniformRadBins(const unsigned& uWf);
+    //returns the inverse bin width if the NumBins bins are equidistant, or equidistant in log (then LogScale is true).
+    //If neither is the case the return value is zero
+    double UniformBinStep(const double* Bins, const unsigned& NumBins, bool& LogScale) const;
+    //the same output as GetBin(Value, Bins, NumBins+1), for InvStep!=0 the bin is computed directly
+    unsigned GetUniformBin(const double& Value, const double* Bins, const unsigned& NumBins, const double& InvStep, const bool& LogScale) const;
 
     template <class Type> Type GetBinCenter(const Type* Bins, const unsigned& WhichBin) const;
     template <class Type> Type EvalBinnedFun(const double& xVal, const unsigned& NumBins, const double* Bins, const double* BinCent, const Type* Function) const;
+    //the same, but with an already known bin of xVal (WhichBin<NumBins)
+    template <class Type> Type EvalBinnedFun(const double& xVal, const unsigned& WhichBin, const unsigned& NumBins, const double* Bins, const double* BinCent, const Type* Function) const;
 
     //double SourceFunction(const double* Pars, const double& GridSize);
     void UpdateCPF();
@@ -627,10 +809,31 @@ protected:
     void DelMomChPw();
     //delete all variables that depend on the number of momentum bins and number of channels
     void DelMomCh();
+    void DelRefPartialWaves();
+    //true if all solutions of the Schroedinger eq. are up to date, i.e. neither a global setting nor a single PW has changed
+    bool WaveFunctionUpToDate() const;
+    //marks a change of the potential (or external WF) of a single channel and PW.
+    //OnlyPars should be true if only the parameters of the potential have changed
+    void SetPwChanged(const unsigned& usCh, const unsigned& usPW, const bool& OnlyPars=false);
+    //marks a solution as not valid. If FullUpdate is false, WaveFunction2 is updated only by replacing the contribution of this PW
+    void InvalidateWaveFunction(const unsigned& uMomBin, const unsigned short& usCh, const unsigned short& usPW, const bool& FullUpdate);
+    //computes the tables of the reference partial waves for all needed momentum bins (if not yet available).
+    //Returns false if the previous tables could not be reused.
+    bool SetUpRefPartialWaves(const unsigned short& NumThreads);
+    void DelPwTerms();
+    //tabulates the potentials of all PWs with PotTableStatus==0
+    void TabulatePotentials(const unsigned short& NumThreads);
+    void DelPotTables();
+    //the radius (in NU) of a grid point, used to evaluate the total wave function
+    double TotWaveFunRadius(const unsigned& uGrid) const;
     //delete all variables that depend only on the number of momentum bins
     void DelMom();
     //delete all variables that depend only on the number of momentum and b-bins
     void DelMomIp();
+    //delete the CATSelder grids of the source
+    void DelSourceGrid();
+    //delete the fixed source grid
+    void DelFixedGrid();
     //delete the potential parameters associated with a particular PW
     void DelPotPw(const unsigned short& usCh, const unsigned short& usPW);
     //delete the potential parameters associated with a particular channel
@@ -651,16 +854,66 @@ protected:
     //limits the amount of memory used to save information about the wave function.
     //unsigned MaxWaveFunBins;
     //the WaveFunRad show the value of r at which the WaveFunction is evaluated
-    unsigned*** SavedWaveFunBins;//in bins of mom/pol/pw
+    //the radial wave function of each mom/pol/pw is saved in its own buffer, accessed by the index WfIndex(uMomBin,usCh,usPW).
+    //The buffers are kept between the computations and reallocated only if more points are needed.
+    unsigned* SavedWaveFunBins;//in bins of WfIndex
+    unsigned* WaveFunCapacity;//in bins of WfIndex, the number of points for which memory is allocated
+    bool* WaveFunValid;//in bins of WfIndex, true if the saved solution is up to date and does not need to be recomputed
+    //in bins of ChPwOffset[usCh]+usPW, non-zero if the potential of this PW has changed since the last ComputeWaveFunction
+    //(1 if only its parameters have changed, 2 if the potential or external WF was replaced).
+    //A change of a single PW is not marked by ComputedWaveFunction, which is used only for global changes
+    unsigned char* PwChanged;
+    //in bins of WfIndex. All bins of WaveFunRad starting from WaveFunUniBin have the same width WaveFunUniStep,
+    //which is used to find the radial bin without a binary search
+    unsigned* WaveFunUniBin;
+    double* WaveFunUniStep;
+    unsigned* ChPwOffset;//in bins of pol, the WfIndex of the first PW of the channel
+    unsigned NumChPw;//the total number of PWs in all channels
     //double*** RadStepWF;//in bins of mom/pol/pw
     double*** PhaseShift;//in bins of mom/pol/pw, saved only until the end of each k-iteration
     float*** PhaseShiftF;//in bins of pol/pw/mom, saved only until the end of each k-iteration
-    double**** WaveFunRad;//in bins of mom/pol/pw/rad, saved only until the end of each k-iteration
-    complex<double>**** WaveFunctionU;//in bins of mom/pol/pw/rad, saved only until the end of each k-iteration
+    double** WaveFunRad;//in bins of WfIndex/rad, saved only until the end of each k-iteration
+    complex<double>** WaveFunctionU;//in bins of WfIndex/rad, saved only until the end of each k-iteration
     bool* MomBinConverged;//bins of mom, marked as true in case the num. comp. failed and this bin should not be used
-
-    //in bins of momentum, channel, GridPoints
-    double*** WaveFunction2;
+    //if set, only the momentum bins marked as true are evaluated by ComputeWaveFunction, ComputeTotWaveFunction and FoldSourceAndWF
+    bool* MomBinSelected;
+    //used by the adaptive evaluation: 0 = nothing computed, 1 = the Schroedinger eq. is solved, 2 = WaveFunction2 is evaluated
+    unsigned short* MomBinStage;
+
+    //in bins of momentum, the channels and GridPoints are a single contiguous array [usCh*NumGridPts+uGrid]
+    double** WaveFunction2;
+    //in bins of [uMomBin*NumCh+usCh], 0 = WaveFunction2 needs to be fully evaluated, 1 = some of the PWs have changed, 2 = up to date
+    unsigned char* WaveFun2Status;
+    //in bins of [uMomBin*NumCh+usCh], the number of incremental updates (Status 1) since WaveFunction2 was fully evaluated
+    unsigned short* WaveFun2NumIncr;
+    //used for SetIncrementalTotWaveFun. In bins of momentum, the contribution of each PW at each GridPoint
+    //[uGrid*NumChPw+ChPwOffset[usCh]+usPW], and for an angular dependent source the amplitude of each channel [usCh*NumGridPts+uGrid]
+    complex<double>** PwTerm;
+    complex<double>** PwAmplitude;
+    bool* PwTermValid;//in bins of WfIndex, true if the saved PwTerm corresponds to the current solution
+
+    //used for SetTabulatedPotential, in bins of ChPwOffset[usCh]+usPW. For each tabulated radius (PotTableStep*(uRad+1) fm)
+    //the value of the potential [2*uRad] and the second derivative of the spline times PotTableStep^2/6 [2*uRad+1].
+    //NULL if the potential is evaluated directly
+    double** PotTable;
+    //0 = the potential needs to be tabulated, 1 = the table is used, 2 = evaluated directly (the table is not accurate enough)
+    unsigned char* PotTableStatus;
+    double PotTableStep;
+
+    //the reference partial waves at the radii of the grid, used in ComputeTotWaveFunction. They do not depend on the
+    //potential, hence they are kept until the grid or the relevant settings (RefPwQ1Q2 etc.) change.
+    //In bins of momentum, the PWs of all GridPoints are a single array [RefPwOffset[uMomBin][uGrid]+usPW]
+    double** RefPartialWave;
+    unsigned** RefPwOffset;
+    double* RefPwRad;//the radii (in NU) for which the tables are computed
+    unsigned RefPwNumGridPts;
+    int RefPwQ1Q2;
+    double RefPwRedMass;
+    unsigned short RefPwMaxPw;
+    bool RefPwTheta;
+    //the max. and the currently used memory (in MB) of the tables, RefPwMemory is set to the max. once a table did not fit
+    double RefPwMaxMemory;
+    double RefPwMemory;
 
     //in bins of momentum/ImpactParameter
     double** kbCorrFun;
@@ -679,14 +932,8 @@ protected:
     DLM_Histo<complex<double>>*** ExternalWF;
     DLM_Histo<complex<double>>*** ExternalPS;
 
-    //these are used as buffers when it comes to computing the Reference Partial Waves and the Legendre Polynomials
-    //in particular, when we loop over all PWs twice, we actually evaluate the same functions multiple times => save them in an array to save CPU time
-    complex<double>* RefPartWave;
-    complex<double>* SolvedPartWave;
-    double* LegPol;
     //the gamow correction factors (Coulomb penetration factor) pre-computed for all momentum bins
     complex<double>* CPF;
-int DEBUG;
 };
 
 #endif // CATS_H
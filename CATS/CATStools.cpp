@@ -4,6 +4,10 @@
 #include <math.h>
 #include <stdio.h>
 #include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 
 #include "gsl_sf_gamma.h"
 
@@ -21,27 +25,55 @@ using namespace std;
 
 //omp_get_num_procs()
 //CATSparameters::CATSparameters(const unsigned type, const unsigned numpar, const bool threadsafe):NumVars(type),NumPars(numpar),TotNumPars(type+numpar),ThreadSafe(threadsafe),NumThreads(omp_get_num_procs()){
-CATSparameters::CATSparameters(const unsigned type, const unsigned numpar, const bool threadsafe):NumVars(type),NumPars(numpar),TotNumPars(type+numpar),ThreadSafe(threadsafe),NumThreads(ThreadSafe?omp_get_num_procs():1){
+//the parameters of each thread are padded to a multiple of the cache line (8 doubles), so that different threads never share a cache line
+CATSparameters::CATSparameters(const unsigned type, const unsigned numpar, const bool threadsafe):NumVars(type),NumPars(numpar),TotNumPars(type+numpar),ThreadSafe(threadsafe),
+    Stride(((type+numpar+7)/8)*8),NumThreads(0),ParBlock(NULL),Parameter(NULL){
 //CATSparameters::CATSparameters(const unsigned type, const unsigned numpar, const bool threadsafe):NumVars(type),NumPars(numpar),TotNumPars(type+numpar),ThreadSafe(threadsafe),NumThreads(1){
-    Parameter = new double* [NumThreads];
-    for(unsigned uThr=0; uThr<NumThreads; uThr++){
-        Parameter[uThr] = new double [TotNumPars];
+    unsigned numthreads = 1;
+    if(ThreadSafe){
+        numthreads = omp_get_num_procs();
+        if(unsigned(omp_get_max_threads())>numthreads) numthreads = omp_get_max_threads();
     }
+    SetNumThreads(numthreads);
 }
 CATSparameters::CATSparameters(const CATSparameters& other):CATSparameters(other.NumVars,other.NumPars,other.ThreadSafe){
+    SetNumThreads(other.NumThreads);
     for(unsigned uThr=0; uThr<NumThreads; uThr++){
         for(unsigned uTotPar=0; uTotPar<TotNumPars; uTotPar++){
-            Parameter[uThr][uTotPar] = other.Parameter[uThr][uTotPar];
+            Parameter[uThr][uTotPar] = uThr<other.NumThreads?other.Parameter[uThr][uTotPar]:other.Parameter[0][uTotPar];
         }
     }
 }
 CATSparameters::~CATSparameters(){
-    for(unsigned uThr=0; uThr<NumThreads; uThr++){
-        delete [] Parameter[uThr];
-    }
+    delete [] ParBlock;
     delete [] Parameter;
 }
 
+void CATSparameters::SetNumThreads(const unsigned& numthreads){
+    if(!ThreadSafe && NumThreads) return;
+    if(numthreads<=NumThreads) return;
+    //a single block, with the first thread starting at a 64 byte boundary
+    double* NewBlock = new double [numthreads*Stride+8];
+    double* First = NewBlock;
+    while(reinterpret_cast<uintptr_t>(First)%64) First++;
+    double** NewParameter = new double* [numthreads];
+    for(unsigned uThr=0; uThr<numthreads; uThr++){
+        NewParameter[uThr] = First+uThr*Stride;
+        for(unsigned uTotPar=0; uTotPar<TotNumPars; uTotPar++){
+            //the new threads start with the values of the first thread
+            NewParameter[uThr][uTotPar] = NumThreads?Parameter[uThr<NumThreads?uThr:0][uTotPar]:0;
+        }
+    }
+    if(ParBlock) delete [] ParBlock;
+    if(Parameter) delete [] Parameter;
+    ParBlock = NewBlock;
+    Parameter = NewParameter;
+    NumThreads = numthreads;
+}
+unsigned CATSparameters::GetNumThreads() const{
+    return NumThreads;
+}
+
 double* CATSparameters::GetParameters() const{
     //if(ThreadId>=NumThreads){
     //    printf("\033[1;31mERROR:\033[0m GetParameters is attempted to access the non-existing ThreadId=%u\n",ThreadId);
@@ -53,6 +85,9 @@ double* CATSparameters::GetParameters() const{
 //if(NumVars==2)printf("GetParameters[%u] -> %p\n", WhichThread, Parameter[WhichThread]);
     return Parameter[WhichThread];
 }
+double* CATSparameters::GetParameters(const unsigned& WhichThread) const{
+    return Parameter[ThreadSafe?WhichThread:0];
+}
 void CATSparameters::SetParameter(const unsigned& WhichPar, const double& Value, const bool& CurrentThread){
     if(WhichPar>=NumPars){
         printf("\033[1;33mWARNING:\033[0m CATSparameters::SetParameter got an non-existing parameter (%u) as an input\n",WhichPar);
@@ -134,7 +169,6 @@ bool CATSparameters::operator ==(const CATSparameters &other) const{
     if(NumPars!=other.NumPars) return false;
     if(TotNumPars!=other.TotNumPars) return false;
     if(ThreadSafe!=other.ThreadSafe) return false;
-    if(NumThreads!=other.NumThreads) return false;
     for(unsigned uThr=0; uThr<NumThreads; uThr++){
         for(unsigned uPar=0; uPar<NumPars; uPar++){
             if(GetParameter(uPar)!=other.GetParameter(uPar)) return false;
@@ -142,6 +176,32 @@ bool CATSparameters::operator ==(const CATSparameters &other) const{
     }
     return true;
 }
+CATSexecution::CATSexecution(const unsigned short& numthreads):NumThreads(numthreads),Nested(false){
+
+}
+CATSexecution::~CATSexecution(){
+
+}
+void CATSexecution::SetNumThreads(const unsigned short& numthreads){
+    NumThreads = numthreads;
+}
+unsigned short CATSexecution::GetNumThreads() const{
+    return NumThreads;
+}
+void CATSexecution::SetNested(const bool& nested){
+    Nested = nested;
+    //the inner regions would otherwise be serialized by OpenMP anyway
+    if(Nested && omp_get_max_active_levels()<2) omp_set_max_active_levels(2);
+}
+bool CATSexecution::GetNested() const{
+    return Nested;
+}
+unsigned short CATSexecution::GetTeamSize() const{
+    if(!Nested && omp_in_parallel()) return 1;
+    unsigned short TeamSize = omp_get_num_procs();
+    if(NumThreads && TeamSize>NumThreads) TeamSize = NumThreads;
+    return TeamSize;
+}
 CatsLorentzVector::CatsLorentzVector(){
     FourSpace[0]=0;
     FourSpace[1]=0;
@@ -367,17 +427,18 @@ CatsParticle::CatsParticle(){
 CatsParticle::~CatsParticle(){
 
 }
-void CatsParticle::ReadFromOscarFile(FILE *InFile){
+bool CatsParticle::ReadFromOscarFile(FILE *InFile){
     int ParticleNr;
-    if(
-        !fscanf(InFile,"%i %i %lf %lf %lf %lf %lf %lf %lf %lf %lf",
+    int NumRead = fscanf(InFile,"%i %i %lf %lf %lf %lf %lf %lf %lf %lf %lf",
         &ParticleNr,&Pid,
         &FourMomentum[1],&FourMomentum[2],&FourMomentum[3],&FourMomentum[0],
         &Mass,
-        &FourSpace[1],&FourSpace[2],&FourSpace[3],&FourSpace[0])){
+        &FourSpace[1],&FourSpace[2],&FourSpace[3],&FourSpace[0]);
+    if(!NumRead){
         printf("\033[1;33mWARNING!\033[0m Possible bad input-file, error when reading the OscarFile!\n");
     }
     ComputeBetaGamma();
+    return NumRead==11;
 }
 void CatsParticle::SetPid(const int& pid){
     Pid=pid;
@@ -799,18 +860,190 @@ void CatsDataBuffer::GoBabyGo(const bool& TauCorrection, const bool& BOOST){
     }
 }
 
+static const char CatsBinaryMagic[8] = {'C','A','T','S','b','i','n','\0'};
+static const uint32_t CatsBinaryVersion = 1;
+static const uint64_t CatsBinaryHeaderSize = 16;
+//event number, number of particles, impact parameter
+static const uint64_t CatsBinaryEventHeaderSize = 16;
+static const unsigned CatsBinaryNumColumns = 9;
+
+CatsBinaryFile::CatsBinaryFile(){
+    FileDescriptor = -1;
+    Data = NULL;
+    FileSize = 0;
+    Position = 0;
+    NumPart = 0;
+    Pid = NULL;
+    for(unsigned uCol=0; uCol<CatsBinaryNumColumns; uCol++) Column[uCol] = NULL;
+}
+CatsBinaryFile::~CatsBinaryFile(){
+    Close();
+}
+bool CatsBinaryFile::Open(const char* fname){
+    Close();
+    FileDescriptor = open(fname, O_RDONLY);
+    if(FileDescriptor<0) return false;
+    struct stat FileStat;
+    if(fstat(FileDescriptor, &FileStat) || uint64_t(FileStat.st_size)<CatsBinaryHeaderSize){
+        Close();
+        return false;
+    }
+    FileSize = FileStat.st_size;
+    void* Map = mmap(NULL, FileSize, PROT_READ, MAP_PRIVATE, FileDescriptor, 0);
+    if(Map==MAP_FAILED){
+        Close();
+        return false;
+    }
+    Data = (const char*)Map;
+    //the file is read only once from the beginning to the end
+    madvise(Map, FileSize, MADV_SEQUENTIAL);
+    uint32_t Version;
+    uint32_t Endianness;
+    memcpy(&Version, Data+8, 4);
+    memcpy(&Endianness, Data+12, 4);
+    if(memcmp(Data, CatsBinaryMagic, 8) || Version!=CatsBinaryVersion || Endianness!=1){
+        Close();
+        return false;
+    }
+    Position = CatsBinaryHeaderSize;
+    return true;
+}
+void CatsBinaryFile::Close(){
+    if(Data) {munmap((void*)Data, FileSize); Data=NULL;}
+    if(FileDescriptor>=0) {close(FileDescriptor); FileDescriptor=-1;}
+    FileSize = 0;
+    Position = 0;
+    NumPart = 0;
+}
+bool CatsBinaryFile::NextEvent(int& EventNumber, int& NumPartInEvent, double& ImpPar){
+    if(!Data || Position+CatsBinaryEventHeaderSize>FileSize) return false;
+    int32_t Header[2];
+    memcpy(Header, Data+Position, 8);
+    memcpy(&ImpPar, Data+Position+8, 8);
+    if(Header[1]<0) return false;
+    uint64_t PidSize = 4*uint64_t(Header[1]);
+    PidSize += PidSize%8;
+    uint64_t EventSize = CatsBinaryEventHeaderSize + PidSize + 8*CatsBinaryNumColumns*uint64_t(Header[1]);
+    if(Position+EventSize>FileSize) return false;
+    EventNumber = Header[0];
+    NumPartInEvent = Header[1];
+    NumPart = Header[1];
+    //all columns are 8 byte aligned, i.e. we can access them directly
+    Pid = (const int32_t*)(Data+Position+CatsBinaryEventHeaderSize);
+    const double* FirstColumn = (const double*)(Data+Position+CatsBinaryEventHeaderSize+PidSize);
+    for(unsigned uCol=0; uCol<CatsBinaryNumColumns; uCol++) Column[uCol] = FirstColumn+uint64_t(uCol)*NumPart;
+    Position += EventSize;
+    return true;
+}
+void CatsBinaryFile::GetParticle(const unsigned& WhichPart, CatsParticle& Particle) const{
+    if(WhichPart>=NumPart) return;
+    Particle.Set(Column[8][WhichPart],Column[5][WhichPart],Column[6][WhichPart],Column[7][WhichPart],
+                 Column[3][WhichPart],Column[0][WhichPart],Column[1][WhichPart],Column[2][WhichPart]);
+    Particle.SetPid(Pid[WhichPart]);
+    Particle.SetMass(Column[4][WhichPart]);
+}
+uint64_t CatsBinaryFile::GetPosition() const{
+    return Position;
+}
+uint64_t CatsBinaryFile::GetSize() const{
+    return FileSize;
+}
+bool CatsBinaryFile::IsBinaryFile(const char* fname){
+    FILE* InFile = fopen(fname, "rb");
+    if(!InFile) return false;
+    char Magic[8];
+    bool Result = fread(Magic, 1, 8, InFile)==8 && !memcmp(Magic, CatsBinaryMagic, 8);
+    fclose(InFile);
+    return Result;
+}
+unsigned CatsBinaryFile::ConvertOscar(const char* OscarFile, const char* BinaryFile, const unsigned short& NumBlankHeaderLines){
+    FILE* InFile = fopen(OscarFile, "r");
+    if(!InFile){
+        printf("\033[1;31mERROR:\033[0m The file\033[0m %s cannot be opened!\n", OscarFile);
+        return 0;
+    }
+    FILE* OutFile = fopen(BinaryFile, "wb");
+    if(!OutFile){
+        printf("\033[1;31mERROR:\033[0m The file\033[0m %s cannot be created!\n", BinaryFile);
+        fclose(InFile);
+        return 0;
+    }
+    char* cdummy = new char [512];
+    for(unsigned short us=0; us<NumBlankHeaderLines; us++){
+        if(!fgets(cdummy, 255, InFile)){
+            printf("\033[1;33mWARNING!\033[0m Possible bad input-file, error when reading from %s!\n",OscarFile);
+        }
+    }
+    uint32_t Endianness = 1;
+    fwrite(CatsBinaryMagic, 1, 8, OutFile);
+    fwrite(&CatsBinaryVersion, 4, 1, OutFile);
+    fwrite(&Endianness, 4, 1, OutFile);
+
+    int EventNumber;
+    int NumPartInEvent;
+    double ImpPar;
+    double fDummy;
+    unsigned NumEvents = 0;
+    unsigned BufferSize = 0;
+    int32_t* PidBuffer = NULL;
+    double* ColumnBuffer = NULL;
+    const int32_t Padding = 0;
+    CatsParticle Particle;
+
+    while(fscanf(InFile,"%i %i %lf %lf",&EventNumber,&NumPartInEvent,&ImpPar,&fDummy)==4){
+        if(NumPartInEvent<0) break;
+        if(unsigned(NumPartInEvent)>BufferSize){
+            if(PidBuffer) delete [] PidBuffer;
+            if(ColumnBuffer) delete [] ColumnBuffer;
+            BufferSize = NumPartInEvent;
+            PidBuffer = new int32_t [BufferSize];
+            ColumnBuffer = new double [CatsBinaryNumColumns*BufferSize];
+        }
+        //in case the file is truncated, we save only the particles that were read in full
+        int NumRead=0;
+        while(NumRead<NumPartInEvent && Particle.ReadFromOscarFile(InFile)){
+            PidBuffer[NumRead] = Particle.GetPid();
+            ColumnBuffer[NumRead] = Particle.GetPx();
+            ColumnBuffer[NumRead+NumPartInEvent] = Particle.GetPy();
+            ColumnBuffer[NumRead+2*NumPartInEvent] = Particle.GetPz();
+            ColumnBuffer[NumRead+3*NumPartInEvent] = Particle.GetE();
+            ColumnBuffer[NumRead+4*NumPartInEvent] = Particle.GetMass();
+            ColumnBuffer[NumRead+5*NumPartInEvent] = Particle.GetX();
+            ColumnBuffer[NumRead+6*NumPartInEvent] = Particle.GetY();
+            ColumnBuffer[NumRead+7*NumPartInEvent] = Particle.GetZ();
+            ColumnBuffer[NumRead+8*NumPartInEvent] = Particle.GetT();
+            NumRead++;
+        }
+        int32_t Header[2] = {EventNumber,NumRead};
+        fwrite(Header, 4, 2, OutFile);
+        fwrite(&ImpPar, 8, 1, OutFile);
+        fwrite(PidBuffer, 4, NumRead, OutFile);
+        if(NumRead%2) fwrite(&Padding, 4, 1, OutFile);
+        for(unsigned uCol=0; uCol<CatsBinaryNumColumns; uCol++){
+            fwrite(&ColumnBuffer[uCol*NumPartInEvent], 8, NumRead, OutFile);
+        }
+        NumEvents++;
+        if(NumRead!=NumPartInEvent) break;
+    }
+
+    if(PidBuffer) delete [] PidBuffer;
+    if(ColumnBuffer) delete [] ColumnBuffer;
+    delete [] cdummy;
+    fclose(InFile);
+    fclose(OutFile);
+    return NumEvents;
+}
+
 CATSnode::CATSnode(CATSelder* elder, const short& depth, const unsigned& firstid, const unsigned& lastid, double* mean, double* len,
                    const CATSnode* TemplateNode):
                    Elder(elder),Depth(depth),FirstID(firstid),LastID(lastid){
     MeanVal = NULL;
     IntLen = NULL;
+    ChildPars = NULL;
     if(elder!=this) StandardNodeInit(mean, len, TemplateNode);
 }
 
 CATSnode::~CATSnode(){
-    if(MeanVal) {delete [] MeanVal; MeanVal=NULL;}
-    if(IntLen) {delete [] IntLen; IntLen=NULL;}
-
     if(child){
         for(unsigned uSub=0; uSub<Elder->NumSubNodes; uSub++){
             delete child[uSub];
@@ -818,6 +1051,8 @@ CATSnode::~CATSnode(){
         delete [] child;
         child = NULL;
     }
+    if(ChildPars) {delete [] ChildPars; ChildPars=NULL;}
+    if(Elder==this && MeanVal) {delete [] MeanVal; MeanVal=NULL; IntLen=NULL;}
 }
 
 unsigned CATSnode::GetNumOfBoxes(){
@@ -836,10 +1071,21 @@ void CATSnode::Update(){
     Update(false);
 }
 
+//the variables are set only for the current thread, thus different nodes can be updated in parallel
 void CATSnode::Update(const bool& ThisNodeOnly){
-    if(Elder->SourceContext){
+    if(Elder->SourceContext && Elder->NumQuadPts>1){
+        double Integral=0;
+        for(unsigned uQuad=0; uQuad<Elder->NumQuadPts; uQuad++){
+            for(short sDim=0; sDim<Elder->Dim; sDim++){
+                Elder->SourcePars->SetVariable(1+sDim,MeanVal[sDim]+Elder->QuadPos[uQuad*Elder->Dim+sDim]*IntLen[sDim],true);
+            }
+            Integral += Elder->QuadWeight[uQuad]*Elder->SourceFunction(Elder->SourceContext);
+        }
+        SourceValue = Integral*GridSize;
+    }
+    else if(Elder->SourceContext){
         for(short sDim=0; sDim<Elder->Dim; sDim++){
-            Elder->SourcePars->SetVariable(1+sDim,MeanVal[sDim],false);
+            Elder->SourcePars->SetVariable(1+sDim,MeanVal[sDim],true);
         }
         SourceValue = Elder->SourceFunction(Elder->SourceContext)*GridSize;
     }
@@ -879,12 +1125,20 @@ void CATSnode::Update(const bool& ThisNodeOnly){
 
 void CATSnode::StandardNodeInit(double* mean, double* len, const CATSnode* TemplateNode){
     SourceValue = 0;
-    MeanVal = new double [Elder->Dim];
-    IntLen = new double [Elder->Dim];
+    if(Elder==this){
+        MeanVal = new double [2*Elder->Dim];
+        IntLen = &MeanVal[Elder->Dim];
+        for(short sDim=0; sDim<Elder->Dim; sDim++){
+            MeanVal[sDim] = mean[sDim];
+            IntLen[sDim] = len[sDim];
+        }
+    }
+    else{
+        MeanVal = mean;
+        IntLen = len;
+    }
     GridSize=1;
     for(short sDim=0; sDim<Elder->Dim; sDim++){
-        MeanVal[sDim] = mean[sDim];
-        IntLen[sDim] = len[sDim];
         GridSize *= IntLen[sDim];
     }
 
@@ -904,57 +1158,61 @@ void CATSnode::StandardNodeInit(double* mean, double* len, const CATSnode* Templ
     }
 
     if( HasChildren ){
+        const short& Dim = Elder->Dim;
         child = new CATSnode* [Elder->NumSubNodes];
+        ChildPars = new double [2*Dim*Elder->NumSubNodes];
         //we want to divide our total interval in two for each parameter on the grid.
         //in order to keep track in which "quadrant" we are, we introduce a very simple counter WhichPart for each
-        //of the parameters, that can only take values 0 or 1. Each time WhichPart[x] is increased to 2, than it is set to zero
-        //and WhichPart[x+1] is increased, i.e. we continue to iterate over the next parameter.
-        char WhichPart[Elder->Dim];
-        double ChildMean[Elder->Dim];
-        double ChildLen[Elder->Dim];
+        //of the parameters, that can only take values 0 or 1, i.e. the bits of uSub
         unsigned ChildNumBoxes = (LastID-FirstID+1)/Elder->NumSubNodes;
-        unsigned ChildFirstID = FirstID;
-        for(short sDim=0; sDim<Elder->Dim; sDim++){
-            WhichPart[sDim] = 0;
-            ChildMean[sDim] = MeanVal[sDim]-IntLen[sDim]*0.25;
-            ChildLen[sDim] = IntLen[sDim]*0.5;
+        for(unsigned uSub=0; uSub<Elder->NumSubNodes; uSub++){
+            double* ChildMean = &ChildPars[2*Dim*uSub];
+            double* ChildLen = &ChildMean[Dim];
+            for(short sDim=0; sDim<Dim; sDim++){
+                const char WhichPart = (uSub>>sDim)&1;
+                ChildMean[sDim] = MeanVal[sDim]-IntLen[sDim]*0.25+0.5*IntLen[sDim]*WhichPart;
+                ChildLen[sDim] = IntLen[sDim]*0.5;
+            }
         }
+        //the children are independent of each other, close to the root they are built as separate tasks
         for(unsigned uSub=0; uSub<Elder->NumSubNodes; uSub++){
-            child[uSub] = new CATSnode(Elder,Depth+1,ChildFirstID,ChildFirstID+ChildNumBoxes-1,ChildMean,ChildLen,
-                                       TemplateNode?TemplateNode->child[uSub]:NULL);
-            ChildFirstID += ChildNumBoxes;
-            for(short sDim=0; sDim<Elder->Dim; sDim++){
-                WhichPart[sDim] = (WhichPart[sDim]+1)%2;
-                ChildMean[sDim] = MeanVal[sDim]-IntLen[sDim]*0.25+0.5*IntLen[sDim]*WhichPart[sDim];
-                if(WhichPart[sDim]) break;
+            const unsigned ChildFirstID = FirstID+uSub*ChildNumBoxes;
+            double* ChildMean = &ChildPars[2*Dim*uSub];
+            const CATSnode* ChildTemplate = TemplateNode?TemplateNode->child[uSub]:NULL;
+            if(Depth<Elder->TaskDepth){
+                #pragma omp task firstprivate(uSub,ChildMean,ChildTemplate)
+                child[uSub] = new CATSnode(Elder,Depth+1,ChildFirstID,ChildFirstID+ChildNumBoxes-1,ChildMean,&ChildMean[Dim],ChildTemplate);
+            }
+            else{
+                child[uSub] = new CATSnode(Elder,Depth+1,ChildFirstID,ChildFirstID+ChildNumBoxes-1,ChildMean,&ChildMean[Dim],ChildTemplate);
             }
         }
     }
-    else{
-        Elder->AddEndNode(this);
-    }
 }
 
 //! see what happens if epsilon==0
 CATSelder::CATSelder(const short& dim, const short& mindep, const short& maxdep, const double& epsilon, double* mean, double* len,
-                     void* context, CATSparameters* Pars, int64_t* gbid, const unsigned& numel, const bool& renorm):
+                     void* context, CATSparameters* Pars, int64_t* gbid, const unsigned& numel, const bool& renorm,
+                     const unsigned short& numthreads, const unsigned short& quadorder):
     CATSnode(this, 0, 0, uipow(2,dim*maxdep)-1, mean, len),
-    Dim(dim),MinDepth(mindep),MaxDepth(maxdep),Epsilon(epsilon),NumSubNodes(uipow(2,Dim)),NumOfEl(numel){
+    Dim(dim),MinDepth(mindep),MaxDepth(maxdep),Epsilon(epsilon),NumSubNodes(uipow(2,Dim)),
+    QuadOrder((context&&quadorder)?quadorder:1),NumOfEl(numel){
 
-    BaseConstructor(mean, len, context, Pars, gbid, numel, NULL, renorm);
+    BaseConstructor(mean, len, context, Pars, gbid, numel, NULL, renorm, numthreads);
 }
 
-CATSelder::CATSelder(const CATSelder* TemplateElder, void* context, CATSparameters* Pars, int64_t* gbid, const unsigned& numel, const bool& renorm):
+CATSelder::CATSelder(const CATSelder* TemplateElder, void* context, CATSparameters* Pars, int64_t* gbid, const unsigned& numel, const bool& renorm,
+                     const unsigned short& numthreads):
     CATSnode(this, 0, 0, uipow(2,TemplateElder->Dim*TemplateElder->MaxDepth)-1, TemplateElder->MeanVal, TemplateElder->IntLen),
     Dim(TemplateElder->Dim),MinDepth(TemplateElder->MinDepth),MaxDepth(TemplateElder->MaxDepth),
-    Epsilon(TemplateElder->Epsilon),NumSubNodes(uipow(2,Dim)),NumOfEl(numel){
+    Epsilon(TemplateElder->Epsilon),NumSubNodes(uipow(2,Dim)),QuadOrder(context?TemplateElder->QuadOrder:1),NumOfEl(numel){
 
-    BaseConstructor(TemplateElder->MeanVal, TemplateElder->IntLen, context, Pars, gbid, numel, TemplateElder, renorm);
+    BaseConstructor(TemplateElder->MeanVal, TemplateElder->IntLen, context, Pars, gbid, numel, TemplateElder, renorm, numthreads);
 
 }
 
 void CATSelder::BaseConstructor(double* mean, double* len, void* context, CATSparameters* Pars, int64_t* gbid, const unsigned& numel,
-                                const CATSelder* TemplateElder, const bool& renorm){
+                                const CATSelder* TemplateElder, const bool& renorm, const unsigned short& numthreads){
 
     if(TemplateElder){
         MaxNumEndNodes = TemplateElder->NumEndNodes;
@@ -987,7 +1245,65 @@ void CATSelder::BaseConstructor(double* mean, double* len, void* context, CATSpa
         SourcePars = NULL;
         GridBoxId = NULL;
     }
+
+    //each thread needs its own copy of the source variables
+    NumThreads = numthreads?numthreads:1;
+    if(SourcePars && NumThreads>SourcePars->NumThreads) NumThreads = SourcePars->NumThreads;
+    //enough tasks to keep all threads busy, even if the tree is not balanced
+    TaskDepth = 0;
+    if(NumThreads>1){
+        for(unsigned NumTasks=1; NumTasks<8*NumThreads && TaskDepth<MaxDepth; NumTasks*=NumSubNodes) TaskDepth++;
+    }
+    EndNodeMean = NULL;
+    EndNodeSize = NULL;
+    GridPtPar = NULL;
+    GridPtValue = NULL;
+
+    //the quadrature points are the tensor product of the one dimensional Gauss-Legendre points
+    NumQuadPts = SourceContext?uipow(QuadOrder,Dim):1;
+    QuadPos = new double [NumQuadPts*Dim];
+    QuadWeight = new double [NumQuadPts];
+    double* Abscissa = new double [QuadOrder];
+    double* Weight = new double [QuadOrder];
+    GaussLegendre(QuadOrder, Abscissa, Weight);
+    for(unsigned uQuad=0; uQuad<NumQuadPts; uQuad++){
+        unsigned Index = uQuad;
+        QuadWeight[uQuad] = 1;
+        for(short sDim=0; sDim<Dim; sDim++){
+            QuadPos[uQuad*Dim+sDim] = 0.5*Abscissa[Index%QuadOrder];
+            QuadWeight[uQuad] *= 0.5*Weight[Index%QuadOrder];
+            Index /= QuadOrder;
+        }
+    }
+    delete [] Abscissa;
+    delete [] Weight;
+
+    #pragma omp parallel num_threads(NumThreads) if(NumThreads>1)
+    {
+    #pragma omp single
     StandardNodeInit(mean, len, TemplateElder);
+    }
+    //the end nodes are in the same order as for a (recursive) single threaded construction
+    CollectEndNodes(this);
+    EndNodeMean = new double [NumEndNodes*Dim];
+    EndNodeSize = new double [NumEndNodes];
+    for(unsigned uNode=0; uNode<NumEndNodes; uNode++){
+        for(short sDim=0; sDim<Dim; sDim++) EndNodeMean[uNode*Dim+sDim] = EndNode[uNode]->MeanVal[sDim];
+        EndNodeSize[uNode] = EndNode[uNode]->GridSize;
+    }
+    //the values at the individual quadrature points are needed only for the end nodes
+    if(NumQuadPts>1){
+        GridPtPar = new double [NumEndNodes*NumQuadPts*Dim];
+        GridPtValue = new double [NumEndNodes*NumQuadPts];
+        for(unsigned uNode=0; uNode<NumEndNodes; uNode++){
+            for(unsigned uQuad=0; uQuad<NumQuadPts; uQuad++){
+                for(short sDim=0; sDim<Dim; sDim++){
+                    GridPtPar[(uNode*NumQuadPts+uQuad)*Dim+sDim] = EndNodeMean[uNode*Dim+sDim]+QuadPos[uQuad*Dim+sDim]*EndNode[uNode]->IntLen[sDim];
+                }
+            }
+        }
+        Update();
+    }
 
     if(TemplateElder && NumEndNodes!=TemplateElder->NumEndNodes){
         printf("\033[1;33mWARNING!\033[0m A potential huge bug in CATSelder::BaseConstructor, please contact the developers!\n");
@@ -1005,6 +1321,9 @@ void CATSelder::Renormalize(){
     for(unsigned uNode=0; uNode<NumEndNodes; uNode++){
         EndNode[uNode]->SourceValue *= SourceRenormError;
     }
+    if(GridPtValue){
+        for(unsigned uPt=0; uPt<NumEndNodes*NumQuadPts; uPt++) GridPtValue[uPt] *= SourceRenormError;
+    }
 
     if(SourceRenormError<1) SourceRenormError = SourceRenormError?1./SourceRenormError:1e64;
     SourceRenormError -= 1;
@@ -1024,6 +1343,74 @@ void CATSelder::Renormalize(){
 CATSelder::~CATSelder(){
     delete [] EndNode;
     EndNode = NULL;
+    delete [] EndNodeMean;
+    EndNodeMean = NULL;
+    delete [] EndNodeSize;
+    EndNodeSize = NULL;
+    delete [] QuadPos;
+    QuadPos = NULL;
+    delete [] QuadWeight;
+    QuadWeight = NULL;
+    if(GridPtPar) {delete [] GridPtPar; GridPtPar = NULL;}
+    if(GridPtValue) {delete [] GridPtValue; GridPtValue = NULL;}
+}
+
+void CATSelder::CollectEndNodes(CATSnode* node){
+    if(!node->child){
+        AddEndNode(node);
+        return;
+    }
+    for(unsigned uSub=0; uSub<NumSubNodes; uSub++) CollectEndNodes(node->child[uSub]);
+}
+
+void CATSelder::Update(){
+    //an analytic source is evaluated directly at the (contiguous) quadrature points or centers of the end nodes,
+    //passing the points of SourceBatchSize/NumQuadPts end nodes at once to the (batch) source
+    if(SourceContext){
+        const unsigned NodesPerBatch = NumQuadPts<SourceBatchSize?SourceBatchSize/NumQuadPts:1;
+        const unsigned NumBatches = (NumEndNodes+NodesPerBatch-1)/NodesPerBatch;
+        const double* PtPar = NumQuadPts>1?GridPtPar:EndNodeMean;
+        #pragma omp parallel num_threads(NumThreads) if(NumThreads>1)
+        {
+        double* BatchRad = new double [NodesPerBatch*NumQuadPts];
+        double* BatchCosTh = Dim>1?new double [NodesPerBatch*NumQuadPts]:NULL;
+        double* BatchValue = new double [NodesPerBatch*NumQuadPts];
+        #pragma omp for
+        for(unsigned uBatch=0; uBatch<NumBatches; uBatch++){
+            const unsigned FirstNode = uBatch*NodesPerBatch;
+            const unsigned LastNode = FirstNode+NodesPerBatch<NumEndNodes?FirstNode+NodesPerBatch:NumEndNodes;
+            const unsigned FirstPt = FirstNode*NumQuadPts;
+            const unsigned NumPts = (LastNode-FirstNode)*NumQuadPts;
+            for(unsigned uPt=0; uPt<NumPts; uPt++){
+                BatchRad[uPt] = PtPar[(FirstPt+uPt)*Dim];
+                if(BatchCosTh) BatchCosTh[uPt] = PtPar[(FirstPt+uPt)*Dim+1];
+            }
+            SourceFunction(SourceContext,NumPts,BatchRad,BatchCosTh,BatchValue);
+            for(unsigned uNode=FirstNode; uNode<LastNode; uNode++){
+                if(NumQuadPts>1){
+                    double Integral=0;
+                    for(unsigned uPt=uNode*NumQuadPts; uPt<(uNode+1)*NumQuadPts; uPt++){
+                        GridPtValue[uPt] = QuadWeight[uPt-uNode*NumQuadPts]*BatchValue[uPt-FirstPt]*EndNodeSize[uNode];
+                        Integral += GridPtValue[uPt];
+                    }
+                    EndNode[uNode]->SourceValue = Integral;
+                }
+                else{
+                    EndNode[uNode]->SourceValue = BatchValue[uNode-FirstNode]*EndNodeSize[uNode];
+                }
+            }
+        }
+        delete [] BatchRad;
+        if(BatchCosTh) delete [] BatchCosTh;
+        delete [] BatchValue;
+        }
+    }
+    else{
+        #pragma omp parallel for num_threads(NumThreads) if(NumThreads>1)
+        for(unsigned uNode=0; uNode<NumEndNodes; uNode++){
+            EndNode[uNode]->Update(true);
+        }
+    }
 }
 
 short CATSelder::GetMaxDepth(){
@@ -1037,23 +1424,23 @@ unsigned CATSelder::GetNumEndNodes(){
 void CATSelder::GetParValues(const unsigned& WhichNode, double* values){
     if(WhichNode>=NumEndNodes) return;
     for(short sDim=0; sDim<Dim; sDim++){
-        values[sDim] = EndNode[WhichNode]->MeanVal[sDim];
+        values[sDim] = EndNodeMean[WhichNode*Dim+sDim];
     }
 }
 double CATSelder::GetParValue(const unsigned& WhichNode, const short& WhichPar){
     if(WhichNode>=NumEndNodes || WhichPar<0 || WhichPar>=Dim) return 0;
-    return EndNode[WhichNode]->MeanVal[WhichPar];
+    return EndNodeMean[WhichNode*Dim+WhichPar];
 }
 
 double CATSelder::GetGridValue(const unsigned& WhichNode, const bool& Normalized){
     if(WhichNode>=NumEndNodes) return 0;
-    return EndNode[WhichNode]->SourceValue/(Normalized?EndNode[WhichNode]->GridSize:1);
+    return EndNode[WhichNode]->SourceValue/(Normalized?EndNodeSize[WhichNode]:1);
 }
 
 double CATSelder::GetGridError(const unsigned& WhichNode, const bool& Normalized){
     if(WhichNode>=NumEndNodes) return 0;
-    if(SourceContext) return SourceRenormError/(Normalized?EndNode[WhichNode]->GridSize:1);
-    else return pow(double(EndNode[WhichNode]->GetNumOfEl()),-0.5)/(Normalized?EndNode[WhichNode]->GridSize:1);
+    if(SourceContext) return SourceRenormError/(Normalized?EndNodeSize[WhichNode]:1);
+    else return pow(double(EndNode[WhichNode]->GetNumOfEl()),-0.5)/(Normalized?EndNodeSize[WhichNode]:1);
 }
 
 void CATSelder::GetGridAxis(const unsigned& WhichNode, double* Axis){
@@ -1062,10 +1449,29 @@ void CATSelder::GetGridAxis(const unsigned& WhichNode, double* Axis){
     }
     if(WhichNode>=NumEndNodes) return;
     for(short sDim=0; sDim<Dim; sDim++){
-        Axis[sDim]=EndNode[WhichNode]->MeanVal[sDim];
+        Axis[sDim]=EndNodeMean[WhichNode*Dim+sDim];
     }
 }
 
+unsigned CATSelder::GetNumGridPts(){
+    return NumEndNodes*NumQuadPts;
+}
+double CATSelder::GetGridPtPar(const unsigned& WhichPt, const short& WhichPar){
+    if(NumQuadPts==1) return GetParValue(WhichPt,WhichPar);
+    if(WhichPt>=NumEndNodes*NumQuadPts || WhichPar<0 || WhichPar>=Dim) return 0;
+    return GridPtPar[WhichPt*Dim+WhichPar];
+}
+double CATSelder::GetGridPtValue(const unsigned& WhichPt){
+    if(NumQuadPts==1) return GetGridValue(WhichPt);
+    if(WhichPt>=NumEndNodes*NumQuadPts) return 0;
+    return GridPtValue[WhichPt];
+}
+double CATSelder::GetGridPtError(const unsigned& WhichPt){
+    if(NumQuadPts==1) return GetGridError(WhichPt);
+    if(WhichPt>=NumEndNodes*NumQuadPts) return 0;
+    return SourceRenormError;
+}
+
 //btw, if the range is outside the limits, the return value will be equal
 //to the NumberOfBoxes. Used somewhere else this might lead to potential segmentation faults, so
 //make sure to take care of that!
@@ -1208,8 +1614,41 @@ double CATSelder::SourceFunction(void* context){
 //printf("CATSelder::SourceFunction\n");
     return static_cast<CATS*>(context)->EvaluateTheSource(SourcePars);
 }
+void CATSelder::SourceFunction(void* context, const unsigned& NumPts, const double* Radius, const double* CosTheta, double* Result){
+    static_cast<CATS*>(context)->EvaluateTheSource(SourcePars,NumPts,Radius,CosTheta,Result);
+}
 
 double CatsSourceForwarder(void* context, double* Pars){return static_cast<CatsSource*>(context)->Eval(Pars);}
+void CatsSourceBatchForwarder(void* context, double* Pars, const unsigned& NumPts, const double* Radius, const double* CosTheta, double* Result){
+    static_cast<CatsSource*>(context)->EvalBatch(Pars,NumPts,Radius,CosTheta,Result);
+}
+
+//the roots of the Legendre polynomial are found with the Newton method, starting from the Chebyshev approximation
+void GaussLegendre(const unsigned short& NumPts, double* Abscissa, double* Weight){
+    if(!NumPts) return;
+    for(unsigned short usRoot=0; usRoot<(NumPts+1)/2; usRoot++){
+        double xVal = cos(Pi*(double(usRoot)+0.75)/(double(NumPts)+0.5));
+        double Derivative;
+        for(unsigned uIter=0; uIter<100; uIter++){
+            //the recurrence relation of the Legendre polynomials
+            double Pl=1;
+            double PlOld=0;
+            for(unsigned short usPol=1; usPol<=NumPts; usPol++){
+                double PlOlder = PlOld;
+                PlOld = Pl;
+                Pl = ((2.*usPol-1.)*xVal*PlOld-(usPol-1.)*PlOlder)/double(usPol);
+            }
+            Derivative = double(NumPts)*(xVal*Pl-PlOld)/(xVal*xVal-1.);
+            double xOld = xVal;
+            xVal = xOld-Pl/Derivative;
+            if(fabs(xVal-xOld)<1e-15) break;
+        }
+        Abscissa[usRoot] = -xVal;
+        Abscissa[NumPts-1-usRoot] = xVal;
+        Weight[usRoot] = 2./((1.-xVal*xVal)*Derivative*Derivative);
+        Weight[NumPts-1-usRoot] = Weight[usRoot];
+    }
+}
 
 CatsSource::~CatsSource(){
 
@@ -1223,6 +1662,14 @@ unsigned CatsSource::GetNumPars(){
 double CatsSource::Eval(double* Pars){
     return 0;
 }
+//the default is to evaluate the scalar Eval point by point
+void CatsSource::EvalBatch(double* Pars, const unsigned& NumPts, const double* Radius, const double* CosTheta, double* Result){
+    for(unsigned uPt=0; uPt<NumPts; uPt++){
+        Pars[1] = Radius[uPt];
+        if(CosTheta) Pars[2] = CosTheta[uPt];
+        Result[uPt] = Eval(Pars);
+    }
+}
 double CatsSource::Eval(const double& Momentum, const double Radius, const double& Angle){
         PARS[0] = Momentum;
         PARS[1] = Radius;
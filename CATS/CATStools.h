@@ -17,6 +17,13 @@ public:
     CATSparameters(const CATSparameters& other);
     ~CATSparameters();
     double* GetParameters() const;
+    //the parameters of a specific thread, e.g. to avoid calling omp_get_thread_num() within a loop
+    double* GetParameters(const unsigned& WhichThread) const;
+    //makes sure that there are separate parameters for (at least) numthreads threads, the new threads get the values of the first thread.
+    //Initially the larger of omp_get_num_procs() and omp_get_max_threads() is used.
+    //!Should not be called within a parallel region
+    void SetNumThreads(const unsigned& numthreads);
+    unsigned GetNumThreads() const;
     //the parameter is set the same for all threads!
     void SetParameter(const unsigned& WhichPar, const double& Value, const bool& CurrentThread=false);
     void SetParameters(const double* pars, const bool& CurrentThread=false);
@@ -35,10 +42,41 @@ protected:
     //dummy+actual parameters
     const unsigned TotNumPars;
     const bool ThreadSafe;
-    const unsigned NumThreads;
+    //the number of doubles reserved for each thread, a multiple of the cache line
+    const unsigned Stride;
+    unsigned NumThreads;
+    //the parameters of all threads, Parameter[uThr] points to the (cache line aligned) ParBlock+uThr*Stride
+    double* ParBlock;
     double** Parameter;
 };
 
+//the thread control of the OpenMP regions in CATS (and in the extensions running a CATS object).
+//A single object can be shared by several CATS objects, such that the thread count is decided at one place,
+//e.g. N independent fits running in parallel with 1 thread each, or a single fit running on N threads.
+//N.B. within the CATS regions omp_get_thread_num() is the thread number in the inner team, i.e. it is NOT unique
+//if the regions are nested inside of another parallel region (several CATS objects computing concurrently).
+//User functions (potentials, sources) keeping any memory per thread should use thread_local storage
+//(as done by the DLM potentials) or the id of the outermost thread (omp_get_ancestor_thread_num(1)).
+class CATSexecution{
+public:
+    CATSexecution(const unsigned short& numthreads=1);
+    ~CATSexecution();
+    //the max. number of threads to be used, 0 means all available cores.
+    //N.B. the number of threads is never larger than omp_get_num_procs()
+    void SetNumThreads(const unsigned short& numthreads);
+    unsigned short GetNumThreads() const;
+    //if false (default), a parallel region that is started from within another active parallel region
+    //(e.g. CATS running inside of a parallel loop over many fits) is executed by a single thread.
+    //If true, the nested regions use the full number of threads (and nested parallelism is enabled in OpenMP)
+    void SetNested(const bool& nested);
+    bool GetNested() const;
+    //the number of threads to be used by a parallel region started at this point
+    unsigned short GetTeamSize() const;
+private:
+    unsigned short NumThreads;
+    bool Nested;
+};
+
 class CatsLorentzVector{
 friend class CatsParticlePair;
 public:
@@ -108,7 +146,8 @@ class CatsParticle:public CatsLorentzVector{
 public:
     CatsParticle();
     ~CatsParticle();
-    void ReadFromOscarFile(FILE *InFile);
+    //returns false if the particle could not be read
+    bool ReadFromOscarFile(FILE *InFile);
     void SetPid(const int& pid);
     void SetMass(const double& mass);
     void SetWidth(const double& width);
@@ -205,6 +244,41 @@ private:
     const CatsParticlePair** PointerToPair;
 };
 
+//a compact binary alternative to the OSCAR files. The file starts with a header (the word "CATSbin", the version and
+//an integer 1 used to check the endianness), followed by the events. Each event consists of the event number, the number
+//of particles and the impact parameter, followed by the particle properties saved column-wise:
+//all Pid (padded to 8 bytes), all px, py, pz, E, mass, x, y, z, t (GeV and fm, as in the OSCAR files).
+//The file is memory mapped, i.e. there is no text parsing and files larger than the RAM can be read as well.
+//Use CatsBinaryFile::ConvertOscar to create such a file. The file set with CATS::SetInputFileName can be of
+//either format, CATS recognizes it automatically when the data is loaded (LoadData).
+class CatsBinaryFile{
+public:
+    CatsBinaryFile();
+    ~CatsBinaryFile();
+    //returns false if the file cannot be opened or is not in the correct format
+    bool Open(const char* fname);
+    void Close();
+    //moves to the next event. Returns false at the end of the file (or if the file is corrupted)
+    bool NextEvent(int& EventNumber, int& NumPart, double& ImpPar);
+    //sets the properties of particle number WhichPart of the current event
+    void GetParticle(const unsigned& WhichPart, CatsParticle& Particle) const;
+    //the current position within the file in bytes
+    uint64_t GetPosition() const;
+    uint64_t GetSize() const;
+    static bool IsBinaryFile(const char* fname);
+    //converts an OSCAR file to the binary format, returns the number of converted events
+    static unsigned ConvertOscar(const char* OscarFile, const char* BinaryFile, const unsigned short& NumBlankHeaderLines=3);
+private:
+    int FileDescriptor;
+    const char* Data;
+    uint64_t FileSize;
+    uint64_t Position;
+    unsigned NumPart;
+    const int32_t* Pid;
+    //px, py, pz, E, mass, x, y, z, t of the current event
+    const double* Column[9];
+};
+
 class CATSelder;
 
 class CATSnode{
@@ -224,10 +298,13 @@ protected:
     const unsigned FirstID;
     const unsigned LastID;
     double SourceValue;
+    //for the elder these are owned by the node, for all other nodes they point to the ChildPars of the parent
     double* MeanVal;
     double* IntLen;
     double GridSize;
     CATSnode** child;
+    //the MeanVal and IntLen of all children, allocated as a single block [uSub*2*Dim], with the IntLen after the MeanVal
+    double* ChildPars;
 
     void Update(const bool& ThisNodeOnly);
     void StandardNodeInit(double* mean, double* len, const CATSnode* TemplateNode=NULL);
@@ -245,11 +322,16 @@ friend class CATSnode;
 public:
     CATSelder(const short& dim, const short& mindep, const short& maxdep, const double& epsilon,
               //double* mean, double* len, double (CATS::*sfun)(const double*, const double&));
-              double* mean, double* len, void* context, CATSparameters* Pars, int64_t* gbid, const unsigned& numel, const bool& renorm=true);
+              double* mean, double* len, void* context, CATSparameters* Pars, int64_t* gbid, const unsigned& numel, const bool& renorm=true,
+              const unsigned short& numthreads=1, const unsigned short& quadorder=1);
+    //the quadrature order is taken from the TemplateElder
     CATSelder(const CATSelder* TemplateElder,
-              void* context, CATSparameters* Pars, int64_t* gbid, const unsigned& numel, const bool& renorm=true);
+              void* context, CATSparameters* Pars, int64_t* gbid, const unsigned& numel, const bool& renorm=true,
+              const unsigned short& numthreads=1);
+    //numthreads is the max number of threads used to build and update the grid. For an analytic source
+    //this is possible only if the Pars are thread safe, in which case each thread uses its own variables
     void BaseConstructor(double* mean, double* len, void* context, CATSparameters* Pars, int64_t* gbid, const unsigned& numel,
-                         const CATSelder* TemplateElder, const bool& renorm=true);
+                         const CATSelder* TemplateElder, const bool& renorm=true, const unsigned short& numthreads=1);
     ~CATSelder();
 
     short GetMaxDepth();
@@ -259,7 +341,17 @@ public:
     double GetGridValue(const unsigned& WhichNode, const bool& Normalized=false);
     double GetGridError(const unsigned& WhichNode, const bool& Normalized=false);
     void GetGridAxis(const unsigned& WhichNode, double* Axis);
+    //for an analytic source with a quadorder>1, the source within each end node is integrated using quadorder^Dim Gauss-Legendre points,
+    //which is used both to decide on the refinement of the grid and for the evaluation of the correlation function.
+    //The grid points are the quadrature points of all end nodes, [uNode*NumQuadPts+uQuad]. For quadorder=1 they are the end nodes.
+    unsigned GetNumGridPts();
+    double GetGridPtPar(const unsigned& WhichPt, const short& WhichPar);
+    //the integral of the source associated with a grid point, the sum over all points of an end node is its GridValue
+    double GetGridPtValue(const unsigned& WhichPt);
+    double GetGridPtError(const unsigned& WhichPt);
     void Renormalize();
+    //reevaluates the source for all end nodes (in parallel), the rest of the tree is not changed
+    void Update();
 
     unsigned GetBoxId(double* particle);
     unsigned FindFirstParticleWithID(const unsigned& gbid);
@@ -273,12 +365,29 @@ protected:
     const short MaxDepth;
     const double Epsilon;
     const unsigned NumSubNodes;
+    const unsigned short QuadOrder;
+    //QuadOrder^Dim, the position of each quadrature point relative to the center of a node (in units of IntLen) [uQuad*Dim+sDim]
+    //and its weight (the sum of which is one)
+    unsigned NumQuadPts;
+    double* QuadPos;
+    double* QuadWeight;
+    //only for NumQuadPts>1, the position [uPt*Dim+sDim] and source integral of each grid point
+    double* GridPtPar;
+    double* GridPtValue;
     unsigned NumEndNodes;
     unsigned MaxNumEndNodes;
     double SourceRenormError;
     unsigned MinEntries;
 
     CATSnode** EndNode;
+    //the MeanVal [uNode*Dim+sDim] and GridSize of the end nodes as contiguous arrays
+    double* EndNodeMean;
+    double* EndNodeSize;
+    unsigned short NumThreads;
+    //the children of nodes below this depth are built as separate (parallel) tasks
+    short TaskDepth;
+    //adds all end nodes below node to EndNode, in the order in which the tree is traversed
+    void CollectEndNodes(CATSnode* node);
 
     //pars and grid-size
     void* SourceContext;
@@ -287,15 +396,26 @@ protected:
     const unsigned NumOfEl;
 
     double SourceFunction(void* context);
+    //evaluates the source at NumPts points at once
+    void SourceFunction(void* context, const unsigned& NumPts, const double* Radius, const double* CosTheta, double* Result);
+    //the (max) number of points passed at once to the source function in Update
+    static const unsigned SourceBatchSize = 256;
 
     //CATS* Kitty;
 };
 
 double CatsSourceForwarder(void* context, double* Pars);
+void CatsSourceBatchForwarder(void* context, double* Pars, const unsigned& NumPts, const double* Radius, const double* CosTheta, double* Result);
+//the abscissas (in [-1,1]) and weights (summing to 2) of the Gauss-Legendre quadrature with NumPts points
+void GaussLegendre(const unsigned short& NumPts, double* Abscissa, double* Weight);
+//N.B. CATS evaluates a forwarded source by a single thread at a time, unless declared thread safe (CATS::SetThreadSafeSource)
 class CatsSource{
 public:
     virtual ~CatsSource();
     virtual double Eval(double* Pars);
+    //evaluates the source at NumPts radii (and cosθ, can be NULL) for the momentum and parameters in Pars.
+    //The default calls Eval for each point, derived classes can override it with a faster version
+    virtual void EvalBatch(double* Pars, const unsigned& NumPts, const double* Radius, const double* CosTheta, double* Result);
     virtual void SetParameter(const unsigned& WhichPar, const double& Value);
     virtual unsigned GetNumPars();
     double Eval(const double& Momentum, const double Radius, const double& Angle);
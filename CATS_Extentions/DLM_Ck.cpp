@@ -176,6 +176,9 @@ double DLM_Ck::GetCutOff_kc() const{
 CATS* DLM_Ck::GetTheCat() const{
     return Kitty;
 }
+void DLM_Ck::SetExecution(CATSexecution* execution){
+    if(Kitty) Kitty->SetExecution(execution);
+}
 
 void DLM_Ck::SetPotPar(const unsigned& WhichPar, const double& Value){
     if(WhichPar>=NumPotPar) return;
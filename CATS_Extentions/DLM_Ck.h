@@ -35,6 +35,8 @@ public:
     double GetCutOff_kc() const;
 
     CATS* GetTheCat() const;
+    //the execution context (thread control) of the underlying CATS object, NULL for its own context
+    void SetExecution(CATSexecution* execution);
 
     bool Status();
     void Update(const bool& FORCE=false);
@@ -355,6 +355,12 @@ DLM_Histo<double>* DLM_CkDecomp::GetChildContribution(const char* name, const bo
 DLM_Ck* DLM_CkDecomp::GetCk(){
     return CkMain;
 }
+void DLM_CkDecomp::SetExecution(CATSexecution* execution){
+    if(CkMain) CkMain->SetExecution(execution);
+    for(unsigned uChild=0; uChild<NumChildren; uChild++){
+        if(Child[uChild]) Child[uChild]->SetExecution(execution);
+    }
+}
 
 const DLM_Histo<float>* DLM_CkDecomp::GetResolutionMatrix(){
     return RM_MomResolution->hSigmaMatrix;
@@ -410,6 +416,10 @@ void DLM_CkDecomp::Update(const bool& FORCE_FULL_UPDATE, const bool& UpdateDecom
     }
 
     if(!CurrentStatus || FORCE_FULL_UPDATE){
+        //all histograms smeared with the momentum resolution are collected and smeared together in the end
+        const DLM_Histo<double>** ToSmear = new const DLM_Histo<double>* [NumChildren+2];
+        DLM_Histo<double>** Smeared = new DLM_Histo<double>* [NumChildren+2];
+        unsigned NumToSmear = 0;
 
         CkMainFeed->Copy(CkMain[0]);
         CkMainFeed->Scale(LambdaMain/MuPar);
@@ -448,18 +458,33 @@ void DLM_CkDecomp::Update(const bool& FORCE_FULL_UPDATE, const bool& UpdateDecom
 //CkMainFeed->Add(uBin, LambdaPar[uChild]/MuPar);
                 }
 				if(UpdateDecomp){
-					Smear(SignalChild[uChild], RM_MomResolution, SignalSmearedChild[uChild]);
-					SignalChild[uChild][0] -= LambdaPar[uChild];
-					SignalSmearedChild[uChild][0] -= LambdaPar[uChild];
+					ToSmear[NumToSmear] = SignalChild[uChild];
+					Smeared[NumToSmear] = SignalSmearedChild[uChild];
+					NumToSmear++;
 				}
             }
             else{
                 *CkMainFeed+=(LambdaPar[uChild]/MuPar);
             }
         }
-        Smear(CkMainFeed, RM_MomResolution, CkSmearedMainFeed);
+        ToSmear[NumToSmear] = CkMainFeed;
+        Smeared[NumToSmear] = CkSmearedMainFeed;
+        NumToSmear++;
         if(UpdateDecomp){
-			Smear(SignalMain, RM_MomResolution, SignalSmearedMain);
+			ToSmear[NumToSmear] = SignalMain;
+			Smeared[NumToSmear] = SignalSmearedMain;
+			NumToSmear++;
+		}
+        Smear(NumToSmear, ToSmear, RM_MomResolution, Smeared);
+        delete [] ToSmear;
+        delete [] Smeared;
+
+        if(UpdateDecomp){
+            for(unsigned uChild=0; uChild<NumChildren; uChild++){
+                if(Type[uChild]!=cFeedDown || !Child[uChild]) continue;
+                SignalChild[uChild][0] -= LambdaPar[uChild];
+                SignalSmearedChild[uChild][0] -= LambdaPar[uChild];
+            }
 			SignalMain[0] -= LambdaMain;
 			SignalSmearedMain[0] -= LambdaMain;
 		}
@@ -469,19 +494,37 @@ void DLM_CkDecomp::Update(const bool& FORCE_FULL_UPDATE, const bool& UpdateDecom
 }
 
 void DLM_CkDecomp::Smear(const DLM_Histo<double>* CkToSmear, const DLM_ResponseMatrix* SmearMatrix, DLM_Histo<double>* CkSmeared){
+    Smear(1, &CkToSmear, SmearMatrix, &CkSmeared);
+}
+
+void DLM_CkDecomp::Smear(const unsigned& NumHisto, const DLM_Histo<double>* const* CkToSmear, const DLM_ResponseMatrix* SmearMatrix, DLM_Histo<double>* const* CkSmeared){
     if(!SmearMatrix){
-        CkSmeared[0] = CkToSmear[0];
+        for(unsigned uHisto=0; uHisto<NumHisto; uHisto++){
+            CkSmeared[uHisto][0] = CkToSmear[uHisto][0];
+        }
+        return;
     }
-    else{
-        for(unsigned uBinSmear=0; uBinSmear<CkToSmear->GetNbins(); uBinSmear++){
-            CkSmeared->SetBinContent(uBinSmear, 0);
+    //the usual case, all histograms have the binning of the matrix and the bin sizes are already included in it
+    bool SameBinning = true;
+    for(unsigned uHisto=0; uHisto<NumHisto && SameBinning; uHisto++){
+        SameBinning = SmearMatrix->SameBinning(CkToSmear[uHisto]) && SmearMatrix->SameBinning(CkSmeared[uHisto]);
+    }
+    if(SameBinning){
+        SmearMatrix->Smear(NumHisto, CkToSmear, CkSmeared);
+        return;
+    }
+    for(unsigned uHisto=0; uHisto<NumHisto; uHisto++){
+        const DLM_Histo<double>* ToSmear = CkToSmear[uHisto];
+        DLM_Histo<double>* Smeared = CkSmeared[uHisto];
+        for(unsigned uBinSmear=0; uBinSmear<ToSmear->GetNbins(); uBinSmear++){
+            Smeared->SetBinContent(uBinSmear, 0);
             unsigned FirstBin = SmearMatrix->SparseResponse[uBinSmear][DLM_ResponseMatrix::xAxisFirst];
             unsigned LastBin = SmearMatrix->SparseResponse[uBinSmear][DLM_ResponseMatrix::xAxisLast];
-            if(LastBin>=CkToSmear->GetNbins()) LastBin = CkToSmear->GetNbins()-1;
+            if(LastBin>=ToSmear->GetNbins()) LastBin = ToSmear->GetNbins()-1;
             for(unsigned uBinTrue=FirstBin; uBinTrue<=LastBin; uBinTrue++){
                 //as the response matrix is normalized to the size of the bin, during the integration we multiply for it
-                CkSmeared->Add(uBinSmear,   SmearMatrix->ResponseMatrix[uBinSmear][uBinTrue]*CkToSmear->GetBinContent(uBinTrue)*
-                                            CkToSmear->GetBinSize(uBinTrue)*CkSmeared->GetBinSize(uBinSmear));
+                Smeared->Add(uBinSmear, SmearMatrix->ResponseMatrix[uBinSmear][uBinTrue]*ToSmear->GetBinContent(uBinTrue)*
+                                        ToSmear->GetBinSize(uBinTrue)*Smeared->GetBinSize(uBinSmear));
             }
         }
     }
@@ -73,6 +73,8 @@ public:
     DLM_Histo<double>* GetChildContribution(const unsigned& WhichChild, const bool& WithLambda=false);
     DLM_Histo<double>* GetChildContribution(const char* name, const bool& WithLambda=false);
     DLM_Ck* GetCk();
+    //sets the execution context (thread control) of all CATS objects in the decomposition tree (incl. the children)
+    void SetExecution(CATSexecution* execution);
 
     const DLM_Histo<float>* GetResolutionMatrix();
 
@@ -137,6 +139,8 @@ protected:
 
     //void SmearOLD(const DLM_Histo<double>* CkToSmear, const DLM_ResponseMatrix* SmearMatrix, DLM_Histo<double>* CkSmeared);
     void Smear(const DLM_Histo<double>* CkToSmear, const DLM_ResponseMatrix* SmearMatrix, DLM_Histo<double>* CkSmeared);
+    //smears NumHisto histograms with the same matrix, in a single pass over the matrix if the binning allows it
+    void Smear(const unsigned& NumHisto, const DLM_Histo<double>* const* CkToSmear, const DLM_ResponseMatrix* SmearMatrix, DLM_Histo<double>* const* CkSmeared);
 };
 
 
@@ -65,6 +65,10 @@ DLM_Fitter1::DLM_Fitter1(const unsigned& maxnumsyst):MaxNumSyst(maxnumsyst),NumP
     ParentPotential = NULL;
     NumSourceSystems = 0;
     NumPotentialSystems = 0;
+    UpdateGroup = NULL;
+    UpdateGroupSize = NULL;
+    NumUpdateGroups = 0;
+    Execution = NULL;
     FitRange = new double* [MaxNumSyst];
     NumSourceMapEntries = 0;
     SameSourceMap = NULL;
@@ -138,6 +142,12 @@ DLM_Fitter1::DLM_Fitter1(const unsigned& maxnumsyst):MaxNumSyst(maxnumsyst),NumP
     HistoGlobal = NULL;
     FitGlobal = NULL;
     GlobalToMomentum = NULL;
+    GlobalToSyst = NULL;
+    NumBinsGlobal = 0;
+    BaseParameter = NULL;
+    GlobalModel = NULL;
+    ModelPars = NULL;
+    ModelUpToDate = false;
     NumBinsSyst = NULL;
     CumulativeNumBinsSyst = NULL;
 
@@ -195,6 +205,10 @@ DLM_Fitter1::~DLM_Fitter1(){
     if(HistoGlobal){delete HistoGlobal; HistoGlobal=NULL;}
     if(FitGlobal){delete FitGlobal; FitGlobal=NULL;}
     if(GlobalToMomentum){delete[]GlobalToMomentum; GlobalToMomentum=NULL;}
+    if(GlobalToSyst){delete[]GlobalToSyst; GlobalToSyst=NULL;}
+    if(BaseParameter){delete[]BaseParameter; BaseParameter=NULL;}
+    if(GlobalModel){delete[]GlobalModel; GlobalModel=NULL;}
+    if(ModelPars){delete[]ModelPars; ModelPars=NULL;}
     if(NumBinsSyst){delete[]NumBinsSyst;NumBinsSyst=NULL;}
     if(CumulativeNumBinsSyst){delete[]CumulativeNumBinsSyst;CumulativeNumBinsSyst=NULL;}
 //printf("~SourceSystems=%p\n",SourceSystems);
@@ -203,6 +217,7 @@ DLM_Fitter1::~DLM_Fitter1(){
     if(ParentParameter) {delete[]ParentParameter; ParentParameter=NULL;}
     if(PotentialSystems) {delete[]PotentialSystems; PotentialSystems=NULL;}
     if(ParentPotential) {delete[]ParentPotential; ParentPotential=NULL;}
+    DelUpdateGroups();
 }
 
 //void DLM_Fitter1::TEST1(const unsigned& WhichSyst, TH1F* histo, const double& FromMeV ,
@@ -776,6 +791,8 @@ void DLM_Fitter1::GetFitGraph(const unsigned& WhichSyst, TGraph& OutGraph, const
 //printf(" HEY -> GetFitGraph!\n");
     if(WhichSyst>=MaxNumSyst) return;
 //printf(" HEY2 -> GetFitGraph!\n");
+    //the Ck functions might have been modified since the last evaluation
+    ModelUpToDate = false;
     OutGraph.Set(NumBinsSyst[WhichSyst]);
     double Momentum;
     if(DataBinning){
@@ -903,6 +920,12 @@ void DLM_Fitter1::SetSeparateBL(const unsigned& WhichSyst, const bool& yesno){
     if(WhichSyst>=MaxNumSyst) return;
     SeparateBaseLineFit[WhichSyst] = yesno;
 }
+void DLM_Fitter1::SetExecution(CATSexecution* execution){
+    Execution = execution;
+}
+CATSexecution* DLM_Fitter1::GetExecution() const{
+    return Execution;
+}
 void DLM_Fitter1::SetFullCkForBaseline(const unsigned& WhichSyst, const bool& yesno){
     if(WhichSyst>=MaxNumSyst) return;
     FullCkForBaseline[WhichSyst] = yesno;
@@ -925,6 +948,7 @@ bool DLM_Fitter1::CheckNegativeCk(){
 }
 
 TF1* DLM_Fitter1::GetFit(){
+    ModelUpToDate = false;
     return FitGlobal;
 }
 TF1* DLM_Fitter1::GetBaselineFit(const unsigned& WhichSyst) const{
@@ -1381,7 +1405,10 @@ void DLM_Fitter1::GoBabyGo(const bool& show_fit_info){
     delete [] buffer;
     delete [] buffer2;
 
-    unsigned NumBinsGlobal = 0;
+//----- NEXT WE FIND THE SYSTEMS THAT CAN BE UPDATED CONCURRENTLY -----
+    SetUpUpdateGroups();
+
+    NumBinsGlobal = 0;
     if(NumBinsSyst) delete [] NumBinsSyst;
     NumBinsSyst = new unsigned [MaxNumSyst];
     if(CumulativeNumBinsSyst) delete [] CumulativeNumBinsSyst;
@@ -1412,6 +1439,10 @@ void DLM_Fitter1::GoBabyGo(const bool& show_fit_info){
     //double* Bin_kVal = new double[NumBinsGlobal];
     if(GlobalToMomentum) delete[]GlobalToMomentum;
     GlobalToMomentum = new double [NumBinsGlobal];
+    if(GlobalToSyst) delete[]GlobalToSyst;
+    GlobalToSyst = new unsigned [NumBinsGlobal];
+    if(GlobalModel) delete[]GlobalModel;
+    GlobalModel = new double [NumBinsGlobal];
 
 
     if(HistoGlobal) delete HistoGlobal;
@@ -1440,6 +1471,7 @@ void DLM_Fitter1::GoBabyGo(const bool& show_fit_info){
 
             if(!TakeThisBin) continue;
             GlobalToMomentum[uBinGlob] = Momentum;
+            GlobalToSyst[uBinGlob] = uSyst;
 //printf(" GlobalToMomentum[%u]=%f\n",uBinGlob,GlobalToMomentum[uBinGlob]);
             CkVal = HistoToFit[uSyst]->GetBinContent(uBin+1);
             CkValErr = HistoToFit[uSyst]->GetBinError(uBin+1);
@@ -1510,10 +1542,25 @@ void DLM_Fitter1::GoBabyGo(const bool& show_fit_info){
         //uActSyst++;
     }
 
+    //the parameter sharing does not change during the fit, i.e. it is resolved only once here
+    if(BaseParameter) delete[]BaseParameter;
+    BaseParameter = new int [MaxNumSyst*NumPar];
+    if(ModelPars) delete[]ModelPars;
+    ModelPars = new double [MaxNumSyst*NumPar];
+    for(unsigned uSyst=0; uSyst<MaxNumSyst; uSyst++){
+        for(unsigned uPar=0; uPar<NumPar; uPar++){
+            BaseParameter[uSyst*NumPar+uPar] = GetBaseParameter(uSyst,uPar);
+        }
+    }
+    ModelUpToDate = false;
+
     //HistoGlobal->Fit(FitGlobal,"V, S, N, R, M");
     if(ShowFitInfo) HistoGlobal->Fit(FitGlobal,"S, N, R, M");
     else HistoGlobal->Fit(FitGlobal,"Q, S, N, R, M");
     //HistoGlobal->Fit(FitGlobal,"Q, N, R, M");
+    //the model of the fit result is recomputed at the first evaluation after GetFitGraph or GetFit (see EvalGlobal),
+    //in case the Ck functions were modified in the meantime
+    ModelUpToDate = false;
 
     for(unsigned uSyst=0; uSyst<MaxNumSyst; uSyst++){
         for(unsigned uPar=0; uPar<NumPar; uPar++){
@@ -1577,42 +1624,104 @@ printf("\n");
 
 }
 
-double DLM_Fitter1::EvalGlobal(double* xVal, double* Pars){
-//printf("CALLING EVALGLOBAL\n");
+//the object behind the forwarded source of the CATS object of Ck, in case it may not be evaluated by several threads at once
+static void* DLM_FITTER1_SOURCE(DLM_Ck* Ck){
+    CATS* Kitty = Ck?Ck->GetTheCat():NULL;
+    if(!Kitty || Kitty->GetThreadSafeSource()) return NULL;
+    return Kitty->GetSourceContext();
+}
+//true if the Node (its DLM_Ck or CATS object, or the source object of the latter) is used anywhere within the Tree
+static bool DLM_FITTER1_CONTAINS(DLM_CkDecomp* Tree, DLM_CkDecomp* Node){
+    if(!Tree || !Node) return false;
+    if(Tree==Node) return true;
+    DLM_Ck* TreeCk = Tree->GetCk();
+    DLM_Ck* NodeCk = Node->GetCk();
+    if(TreeCk && TreeCk==NodeCk) return true;
+    if(TreeCk && NodeCk && TreeCk->GetTheCat() && TreeCk->GetTheCat()==NodeCk->GetTheCat()) return true;
+    void* TreeSource = DLM_FITTER1_SOURCE(TreeCk);
+    if(TreeSource && TreeSource==DLM_FITTER1_SOURCE(NodeCk)) return true;
+    for(unsigned uChild=0; uChild<Tree->GetNumChildren(); uChild++){
+        if(DLM_FITTER1_CONTAINS(Tree->GetChild(uChild),Node)) return true;
+    }
+    return false;
+}
+//true if the two trees have any object in common
+static bool DLM_FITTER1_OVERLAP(DLM_CkDecomp* TreeA, DLM_CkDecomp* TreeB){
+    if(!TreeA || !TreeB) return false;
+    if(DLM_FITTER1_CONTAINS(TreeB,TreeA)) return true;
+    for(unsigned uChild=0; uChild<TreeA->GetNumChildren(); uChild++){
+        if(DLM_FITTER1_OVERLAP(TreeA->GetChild(uChild),TreeB)) return true;
+    }
+    return false;
+}
 
-//static unsigned NUM_FUN_CALLS = 0;
-//NUM_FUN_CALLS++;
-//if(NUM_FUN_CALLS%10==0){
-//printf("FUNCTION CALL %u\n",NUM_FUN_CALLS);
-//}
-//double L1,L2,PV;
-//FitGlobal->GetParLimits(p_sor0,L1,L2);
-//PV=FitGlobal->GetParameter(p_sor0);
-//printf(" __xVal=%f\n",*xVal);
-//printf(" B__Pars[p_sor0]=%f\n",Pars[p_sor0]);
-//printf(" B__FitGlobal=%f (%f, %f)\n",PV,L1,L2);
-    unsigned GlobalBin = HistoGlobal->FindBin(*xVal)-1;
-    double Momentum = GlobalToMomentum[GlobalBin];
-    unsigned WhichSyst=0;
-//printf("Pars0[p_sor0/1/2] = %.2f/%.2f/%.2f\n",Pars[p_sor0],Pars[p_sor1],Pars[p_sor2]);
-//printf("Pars1[p_sor0/1/2] = %.2f/%.2f/%.2f\n",Pars[NumPar+p_sor0],Pars[NumPar+p_sor1],Pars[NumPar+p_sor2]);
-
-//for(unsigned uPar=0; uPar<NumPar; uPar++){
-//    PV=FitGlobal->GetParameter(uPar);
-//    FitGlobal->GetParLimits(uPar,L1,L2);
-//    printf(" __Pars[%u]=%f\n",uPar,Pars[uPar]);
-//    printf(" __FitGlobal=%f (%f, %f)\n\n",PV,L1,L2);
-//}
-//printf(" __Pars[p_sor0]=%f\n",Pars[p_sor0]);
-//printf(" __FitGlobal=%f (%f, %f)\n",PV,L1,L2);
+void DLM_Fitter1::SetUpUpdateGroups(){
+    DelUpdateGroups();
+    const unsigned NumEntries = NumSourceSystems+NumPotentialSystems+MaxNumSyst;
+    DLM_CkDecomp** Entry = new DLM_CkDecomp* [NumEntries];
+    int* EntryGroup = new int [NumEntries];
+    unsigned uEntry=0;
+    for(unsigned uSource=0; uSource<NumSourceSystems; uSource++) Entry[uEntry++] = SourceSystems[uSource];
+    for(unsigned uPotential=0; uPotential<NumPotentialSystems; uPotential++) Entry[uEntry++] = PotentialSystems[uPotential];
+    for(unsigned uSyst=0; uSyst<MaxNumSyst; uSyst++) Entry[uEntry++] = SystemToFit[uSyst];
+
+    //each entry starts in its own group, overlapping entries are merged (the group of an entry is the lowest index of all entries it is connected to)
+    for(uEntry=0; uEntry<NumEntries; uEntry++){
+        EntryGroup[uEntry] = Entry[uEntry]?int(uEntry):-1;
+    }
+    for(uEntry=0; uEntry<NumEntries; uEntry++){
+        if(!Entry[uEntry]) continue;
+        for(unsigned uPrev=0; uPrev<uEntry; uPrev++){
+            if(!Entry[uPrev] || EntryGroup[uPrev]==EntryGroup[uEntry]) continue;
+            if(!DLM_FITTER1_OVERLAP(Entry[uPrev],Entry[uEntry])) continue;
+            const int OldGroup = EntryGroup[uPrev]>EntryGroup[uEntry]?EntryGroup[uPrev]:EntryGroup[uEntry];
+            const int NewGroup = EntryGroup[uPrev]<EntryGroup[uEntry]?EntryGroup[uPrev]:EntryGroup[uEntry];
+            for(unsigned uOther=0; uOther<=uEntry; uOther++){
+                if(EntryGroup[uOther]==OldGroup) EntryGroup[uOther] = NewGroup;
+            }
+        }
+    }
 
-    for(unsigned uSyst=0; uSyst<MaxNumSyst; uSyst++){
-        if(!HistoToFit[uSyst]) continue;
-        //determine in which system the GlobalBin is
-        if(GlobalBin<CumulativeNumBinsSyst[uSyst]) {WhichSyst=uSyst; break;}
+    NumUpdateGroups = 0;
+    for(uEntry=0; uEntry<NumEntries; uEntry++){
+        NumUpdateGroups += (EntryGroup[uEntry]==int(uEntry));
+    }
+    UpdateGroup = NumUpdateGroups?new DLM_CkDecomp** [NumUpdateGroups]:NULL;
+    UpdateGroupSize = NumUpdateGroups?new unsigned [NumUpdateGroups]:NULL;
+    unsigned uGroup=0;
+    for(uEntry=0; uEntry<NumEntries; uEntry++){
+        if(EntryGroup[uEntry]!=int(uEntry)) continue;
+        UpdateGroupSize[uGroup] = 0;
+        for(unsigned uMember=uEntry; uMember<NumEntries; uMember++){
+            UpdateGroupSize[uGroup] += (EntryGroup[uMember]==int(uEntry));
+        }
+        UpdateGroup[uGroup] = new DLM_CkDecomp* [UpdateGroupSize[uGroup]];
+        unsigned uPos=0;
+        for(unsigned uMember=uEntry; uMember<NumEntries; uMember++){
+            if(EntryGroup[uMember]==int(uEntry)) UpdateGroup[uGroup][uPos++] = Entry[uMember];
+        }
+        uGroup++;
     }
 
-    if(!SystemToFit[WhichSyst]) return 0;
+    delete [] Entry;
+    delete [] EntryGroup;
+}
+
+void DLM_Fitter1::DelUpdateGroups(){
+    if(UpdateGroup){
+        for(unsigned uGroup=0; uGroup<NumUpdateGroups; uGroup++){
+            delete [] UpdateGroup[uGroup];
+        }
+        delete [] UpdateGroup;
+        UpdateGroup = NULL;
+    }
+    if(UpdateGroupSize){delete[]UpdateGroupSize; UpdateGroupSize=NULL;}
+    NumUpdateGroups = 0;
+}
+
+double DLM_Fitter1::EvalGlobal(double* xVal, double* Pars){
+    unsigned GlobalBin = HistoGlobal->FindBin(*xVal)-1;
+    if(GlobalBin>=NumBinsGlobal) return 0;
 
     //we make sure ALL Pars are set to a meaningful value (i.e. in case there is a parent, we substitute the value)
     for(unsigned uSyst=0; uSyst<MaxNumSyst; uSyst++){
@@ -1620,34 +1729,34 @@ double DLM_Fitter1::EvalGlobal(double* xVal, double* Pars){
             if(FixPar[uSyst][uPar]){
                 Pars[uSyst*NumPar+uPar]=ParValue[uSyst][uPar];
             }
-if(uPar>=NumPar) printf("AAA h\n");
-            int uParentParameter = GetBaseParameter(uSyst,uPar);
-            Pars[uSyst*NumPar+uPar]=Pars[uParentParameter];
+            Pars[uSyst*NumPar+uPar]=Pars[BaseParameter[uSyst*NumPar+uPar]];
         }
     }
-/*
-    for(unsigned uPar=0; uPar<NumPar; uPar++){
-        //if(ParentParameter[WhichSyst*NumPar+uPar]!=-1){
-        int WhichParentParameter = GetBaseParameter(WhichSyst,uPar);
-//printf("hi\n");
-//if(WhichSyst==1){
-//printf("WhichSyst=%u; WhichSyst*NumPar+uPar=%u; WhichParentParameter=%i; Pars[%u]=%f\n",
-//       WhichSyst,WhichSyst*NumPar+uPar,WhichParentParameter,WhichSyst*NumPar+uPar,Pars[WhichSyst*NumPar+uPar]);
-//}
-        if(WhichParentParameter!=int(WhichSyst*NumPar+uPar)){
-            Pars[WhichSyst*NumPar+uPar]=Pars[WhichParentParameter];
-//printf("Pars[%u]=Pars[%i]=%f\n",WhichSyst*NumPar+uPar,WhichParentParameter,Pars[WhichParentParameter]);
+
+    //ROOT calls this function bin by bin, the full model (all bins of all systems) is computed only
+    //for the first bin evaluated with a new set of parameters, all other bins are taken from GlobalModel
+    bool SameParameters = ModelUpToDate;
+    for(unsigned uPar=0; uPar<MaxNumSyst*NumPar; uPar++){
+        if(!SameParameters) break;
+        SameParameters = (ModelPars[uPar]==Pars[uPar]);
+    }
+    if(!SameParameters){
+        for(unsigned uPar=0; uPar<MaxNumSyst*NumPar; uPar++){
+            ModelPars[uPar] = Pars[uPar];
         }
+        UpdateSystems(Pars);
+        for(unsigned uBin=0; uBin<NumBinsGlobal; uBin++){
+            GlobalModel[uBin] = EvalModel(uBin,Pars);
+        }
+        ModelUpToDate = true;
     }
-*/
 
+    return GlobalModel[GlobalBin];
+}
 
-    //determine if we are in the femto region. If false => we are in the linear or flat region
-    bool FemtoRegion = (Momentum<=FitRange[WhichSyst][kf]);
+void DLM_Fitter1::UpdateSystems(const double* Pars){
     //loop over all systems that may need to have their source size adjusted
     //adjust the source of their corresponding "source-parent"
-//printf("WTF man\n");
-//usleep(0.1e6);
     for(unsigned uSource=0; uSource<NumSourceSystems; uSource++){
         for(unsigned uPar=0; uPar<SourceSystems[uSource]->GetCk()->GetNumSourcePar(); uPar++){
 //char buffer[32];
@@ -1655,17 +1764,6 @@ if(uPar>=NumPar) printf("AAA h\n");
 //printf("ssName=%s\n",buffer);
             SourceSystems[uSource]->GetCk()->SetSourcePar(uPar, Pars[ParentSource[uSource]*NumPar+p_sor0+uPar]);
         }
-        //GetNumSourcePar
-
-        //SourceSystems[uSource]->GetCk()->SetSourcePar(0, Pars[ParentSource[uSource]*NumPar+p_sor0]);
-//this is quite badly implemented! The idea is to check if there are more than 1 source parameters, however at the moment
-//I only check the main system, but there is no check if all systems are defined equivalently!
-        //if(!FixPar[0][p_sor1])
-            //SourceSystems[uSource]->GetCk()->SetSourcePar(1, Pars[ParentSource[uSource]*NumPar+p_sor1]);
-        //if(!FixPar[0][p_sor2])
-            //SourceSystems[uSource]->GetCk()->SetSourcePar(2, Pars[ParentSource[uSource]*NumPar+p_sor2]);
-        //if(!FixPar[0][p_sor3])
-            //SourceSystems[uSource]->GetCk()->SetSourcePar(3, Pars[ParentSource[uSource]*NumPar+p_sor3]);
     }
 /*
     for(unsigned uSyst=0; uSyst<MaxNumSyst; uSyst++){
@@ -1688,49 +1786,67 @@ if(uPar>=NumPar) printf("AAA h\n");
 
     //update all systems. It is better to do this here than in the loop before,
     //in order to make sure that ALL systems have their sources adjusted before the update
-    for(unsigned uSource=0; uSource<NumSourceSystems; uSource++){
-        SourceSystems[uSource]->Update(false);
-    }
-    for(unsigned uPotential=0; uPotential<NumPotentialSystems; uPotential++){
-        PotentialSystems[uPotential]->Update(false);
-    }
-    for(unsigned uSyst=0; uSyst<MaxNumSyst; uSyst++){
-        SystemToFit[uSyst]->Update(false);
+    //the groups are independent, i.e. they can be updated concurrently. Within a group the order is
+    //the same as before: first the SourceSystems, than the PotentialSystems and finally the SystemToFit
+    unsigned short NumThreads = 1;
+    if(Execution && NumUpdateGroups>1){
+        //a parallel region is opened only if at least two groups actually need an update (not the case for most of the calls)
+        unsigned NumOutdatedGroups = 0;
+        for(unsigned uGroup=0; uGroup<NumUpdateGroups; uGroup++){
+            for(unsigned uEntry=0; uEntry<UpdateGroupSize[uGroup]; uEntry++){
+                if(!UpdateGroup[uGroup][uEntry]->Status()){NumOutdatedGroups++; break;}
+            }
+        }
+        NumThreads = Execution->GetTeamSize();
+        if(NumThreads>NumOutdatedGroups) NumThreads = NumOutdatedGroups?NumOutdatedGroups:1;
+    }
+    //N.B. the user functions of the different groups are running concurrently (see SetExecution)
+    #pragma omp parallel for schedule(dynamic) num_threads(NumThreads) if(NumThreads>1)
+    for(unsigned uGroup=0; uGroup<NumUpdateGroups; uGroup++){
+        for(unsigned uEntry=0; uEntry<UpdateGroupSize[uGroup]; uEntry++){
+            UpdateGroup[uGroup][uEntry]->Update(false);
+        }
     }
+}
+
+double DLM_Fitter1::EvalModel(const unsigned& GlobalBin, double* Pars){
+    double Momentum = GlobalToMomentum[GlobalBin];
+    const unsigned WhichSyst = GlobalToSyst[GlobalBin];
+    if(!SystemToFit[WhichSyst]) return 0;
+    //determine if we are in the femto region. If false => we are in the linear or flat region
+    bool FemtoRegion = (Momentum<=FitRange[WhichSyst][kf]);
+    double* SystPars = &Pars[WhichSyst*NumPar];
 
     double CkVal;
     double BlVal;
+    //the polynomials are evaluated with the Horner scheme
+    BlVal = SystPars[p_b]+Momentum*(SystPars[p_c]+Momentum*(SystPars[p_3]+Momentum*SystPars[p_4]));
     if(TypeMultBl==0){
-        BlVal = Pars[WhichSyst*NumPar+p_a]+Pars[WhichSyst*NumPar+p_b]*Momentum+Pars[WhichSyst*NumPar+p_c]*Momentum*Momentum+
-                Pars[WhichSyst*NumPar+p_3]*pow(Momentum,3.)+Pars[WhichSyst*NumPar+p_4]*pow(Momentum,4.);
+        BlVal = SystPars[p_a]+Momentum*BlVal;
     }
     else{
-        BlVal = Pars[WhichSyst*NumPar+p_a]*(1.+Pars[WhichSyst*NumPar+p_b]*Momentum+Pars[WhichSyst*NumPar+p_c]*Momentum*Momentum+
-                Pars[WhichSyst*NumPar+p_3]*pow(Momentum,3.)+Pars[WhichSyst*NumPar+p_4]*pow(Momentum,4.));
+        BlVal = SystPars[p_a]*(1.+Momentum*BlVal);
     }
 
     //in case we are to use splines
-    if(Pars[WhichSyst*NumPar+p_spline]!=0){
-        BlVal *= DLM_FITTER2_FUNCTION_SPLINE3(&Momentum,&Pars[WhichSyst*NumPar+p_spline]);
+    if(SystPars[p_spline]!=0){
+        BlVal *= DLM_FITTER2_FUNCTION_SPLINE3(&Momentum,&SystPars[p_spline]);
     }
     double AddBlVal;
+    AddBlVal = SystPars[p_ab_1]+Momentum*(SystPars[p_ab_2]+Momentum*(SystPars[p_ab_3]+Momentum*(SystPars[p_ab_4]+
+                Momentum*(SystPars[p_ab_5]+Momentum*SystPars[p_ab_6]))));
     if(TypeAddBl==0){
-        AddBlVal = Pars[WhichSyst*NumPar+p_ab_0]+Pars[WhichSyst*NumPar+p_ab_1]*Momentum+Pars[WhichSyst*NumPar+p_ab_2]*Momentum*Momentum+
-    Pars[WhichSyst*NumPar+p_ab_3]*pow(Momentum,3.)+Pars[WhichSyst*NumPar+p_ab_4]*pow(Momentum,4.)+Pars[WhichSyst*NumPar+p_ab_5]*pow(Momentum,5.)
-    +Pars[WhichSyst*NumPar+p_ab_6]*pow(Momentum,6.);
+        AddBlVal = SystPars[p_ab_0]+Momentum*AddBlVal;
     }
     else{
-        AddBlVal = Pars[WhichSyst*NumPar+p_ab_0]*(1.+Pars[WhichSyst*NumPar+p_ab_1]*Momentum+Pars[WhichSyst*NumPar+p_ab_2]*Momentum*Momentum+
-                    Pars[WhichSyst*NumPar+p_ab_3]*pow(Momentum,3.)+Pars[WhichSyst*NumPar+p_ab_4]*pow(Momentum,4.)+Pars[WhichSyst*NumPar+p_ab_5]*pow(Momentum,5.)
-                    +Pars[WhichSyst*NumPar+p_ab_6]*pow(Momentum,6.));
+        AddBlVal = SystPars[p_ab_0]*(1.+Momentum*AddBlVal);
     }
 
-
     double Clin;
     //Oli's way
     if(SeparateBaseLineFit[WhichSyst] && FullCkForBaseline[WhichSyst]==false ){
         if(FemtoRegion){
-            CkVal = SystemToFit[WhichSyst]->EvalCk(Momentum)/fabs(Pars[WhichSyst*NumPar+p_Cl]);
+            CkVal = SystemToFit[WhichSyst]->EvalCk(Momentum)/fabs(SystPars[p_Cl]);
         }
         else{
             CkVal = 1;
@@ -1741,21 +1857,21 @@ if(uPar>=NumPar) printf("AAA h\n");
             CkVal = SystemToFit[WhichSyst]->EvalCk(Momentum);
         }
         else{
-            if(Pars[WhichSyst*NumPar+p_Cl]==-1e6){
+            if(SystPars[p_Cl]==-1e6){
                 Clin = SystemToFit[WhichSyst]->EvalCk(FitRange[WhichSyst][kf]);
             }
             else{
-                Clin = fabs(Pars[WhichSyst*NumPar+p_Cl]);
+                Clin = fabs(SystPars[p_Cl]);
             }
-            if(Pars[WhichSyst*NumPar+p_kc]==-1e6){
+            if(SystPars[p_kc]==-1e6){
                 CkVal = Clin;
             }
-            else if(Pars[WhichSyst*NumPar+p_kc]==FitRange[WhichSyst][kl]){
+            else if(SystPars[p_kc]==FitRange[WhichSyst][kl]){
                 CkVal = 1e6;
             }
             else{
-                CkVal = ((Momentum-FitRange[WhichSyst][kl])-Clin*(Momentum-Pars[WhichSyst*NumPar+p_kc]))/
-                        (Pars[WhichSyst*NumPar+p_kc]-FitRange[WhichSyst][kl]);
+                CkVal = ((Momentum-FitRange[WhichSyst][kl])-Clin*(Momentum-SystPars[p_kc]))/
+                        (SystPars[p_kc]-FitRange[WhichSyst][kl]);
             }
             if(Clin<1 && CkVal>1) CkVal=1;
             if(Clin>1 && CkVal<1) CkVal=1;
@@ -1775,8 +1891,6 @@ if(uPar>=NumPar) printf("AAA h\n");
         //printf("SystemToFit[WhichSyst]->EvalMain(%.3f)=%.3f\n", Momentum, SystemToFit[WhichSyst]->EvalMain(Momentum));
     }
 
-//printf(" E__Pars[p_sor0]=%f\n",Pars[p_sor0]);
-//printf(" E__FitGlobal=%f (%f, %f)\n",PV,L1,L2);
     return BlVal*CkVal+AddBlVal;
 }
 
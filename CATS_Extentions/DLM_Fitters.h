@@ -13,6 +13,7 @@
 //typedef double (*CatsAnaSource)(double*);
 
 class DLM_CkDecomp;
+class CATSexecution;
 class TGraph;
 class TGraphErrors;
 class TH1F;
@@ -100,8 +101,20 @@ public:
     void RemoveNegativeCk(const bool& yesno);
     bool CheckNegativeCk();
 
+    //if set, the independent systems (i.e. not sharing any contribution, DLM_Ck or CATS object, nor the object of a forwarded
+    //source that is not declared thread safe, see CATS::SetThreadSafeSource) are updated concurrently,
+    //with the number of threads taken from this execution context. NULL (default) = the systems are updated one by one.
+    //N.B. with the default (non-nested) context, each CATS object will run on a single thread within the concurrent update
+    //N.B. all user functions (sources, potentials) of the systems must be thread safe in this case, i.e. not use any
+    //global or static memory (thread_local is fine), as different systems are computed at the same time. Within such
+    //an update omp_get_thread_num() is NOT unique (it is always 0 for the non-nested context), see CATSexecution
+    void SetExecution(CATSexecution* execution);
+    CATSexecution* GetExecution() const;
+
     const unsigned GetNumParPerSyst(){return NumPar;}
 
+    //the model is recomputed at the first evaluation of the returned function, later evaluations with the same parameters
+    //reuse it. In case the Ck functions are modified after that, call GetFit again before evaluating
     TF1* GetFit();
     TF1* GetBaselineFit(const unsigned& WhichSyst) const;
     const TH1F* GetGlobalHisto() const;
@@ -151,6 +164,14 @@ private:
     //the ID in the main array of the Ck to which the source of a system is fixed
     int* ParentPotential;
 
+    //all systems that need an update (SourceSystems, PotentialSystems and SystemToFit, in this order),
+    //sorted into groups that have no object in common. The groups are updated concurrently, the entries of each group sequentially.
+    //[WhichGroup][WhichEntry]
+    DLM_CkDecomp*** UpdateGroup;
+    unsigned* UpdateGroupSize;
+    unsigned NumUpdateGroups;
+    CATSexecution* Execution;
+
     //[WhichSyst][0-3] 0-3: kMin,kFemto,kLinear,kMax
     double** FitRange;
 
@@ -179,6 +200,15 @@ private:
     TF1** FitBL;
 
     double* GlobalToMomentum;
+    //the system to which each global bin belongs
+    unsigned* GlobalToSyst;
+    unsigned NumBinsGlobal;
+    //[WhichSyst*NumPar+WhichPar] the result of GetBaseParameter, evaluated once before the fit
+    int* BaseParameter;
+    //the model for all global bins, computed once for each set of parameters (ModelPars)
+    double* GlobalModel;
+    double* ModelPars;
+    bool ModelUpToDate;
     unsigned* NumBinsSyst;
     unsigned* CumulativeNumBinsSyst;
 
@@ -187,6 +217,12 @@ private:
     //unsigned SourceAnchoredTo(const);
 
     double EvalGlobal(double* xVal, double* Pars);
+    //sets the source and potential parameters and updates all systems
+    void UpdateSystems(const double* Pars);
+    //the fit function for a single global bin, assuming the systems are up to date
+    double EvalModel(const unsigned& GlobalBin, double* Pars);
+    void SetUpUpdateGroups();
+    void DelUpdateGroups();
     int GetBaseParameter(const int& WhichSyst, const int& WhichPar, int& ParentSystem, int& ParentPar, const int& StartSystem, const int& StartPar);
     int GetBaseParameter(const TString& System, const int& WhichPar, TString& ParentSystem, int& ParentPar, const TString& StartSystem, const int& StartPar);
 
@@ -11,27 +11,57 @@
 
 //int DlmPot=0;
 //int DlmPotFlag=0;
-DLM_StefanoPotentials*** fV18pot=NULL;
+//DLM_StefanoPotentials is not thread safe, thus each thread has its own set of potentials [thread][StefPotId].
+//The set is found by a thread_local pointer and not by omp_get_thread_num, which is not unique if several
+//parallel regions run concurrently (nested, or e.g. DLM_Fitter1 updating its systems in parallel).
+//All sets are saved in fV18pot, such that CleanUpV18Pot can delete them
+std::vector<DLM_StefanoPotentials**> fV18pot;
+//increased by CleanUpV18Pot, a thread with an older set of potentials makes a new one
+unsigned V18PotGeneration=0;
+thread_local DLM_StefanoPotentials** fV18potThread=NULL;
+thread_local unsigned V18PotThreadGeneration=0;
 //[lpot][lemp][slj]
 DLM_Histo<float>*** fNorfolkPot_pp=NULL;
 
-unsigned NumThreads_DLMPOT;
-
+//N.B. should not be called while the potentials are in use by other threads
 void CleanUpV18Pot(){
-    if(fV18pot){
-        for(unsigned uThread=0; uThread<NumThreads_DLMPOT; uThread++){
-            if(fV18pot[uThread]){
-                for(unsigned iPot=0; iPot<30; iPot++){
-                    if(fV18pot[uThread][iPot]){delete fV18pot[uThread][iPot]; fV18pot[uThread][iPot]=NULL;}
-                }
-                delete [] fV18pot[uThread];
-                fV18pot[uThread] = NULL;
-            }
+    #pragma omp critical(DLM_V18POT)
+    {
+    for(unsigned uThread=0; uThread<fV18pot.size(); uThread++){
+        for(unsigned iPot=0; iPot<30; iPot++){
+            if(fV18pot[uThread][iPot]){delete fV18pot[uThread][iPot]; fV18pot[uThread][iPot]=NULL;}
         }
-        delete [] fV18pot;
-        fV18pot = NULL;
+        delete [] fV18pot[uThread];
+    }
+    fV18pot.clear();
+    V18PotGeneration++;
     }
+}
 
+//the potential V18Pot (in the numbering of DLM_StefanoPotentials) of the current thread
+static DLM_StefanoPotentials* GetV18Pot(const int& V18Pot){
+    if(!fV18potThread || V18PotThreadGeneration!=V18PotGeneration){
+        fV18potThread = new DLM_StefanoPotentials* [30];
+        for(unsigned uPot=0; uPot<30; uPot++){
+            fV18potThread[uPot] = NULL;
+        }
+        #pragma omp critical(DLM_V18POT)
+        {
+        fV18pot.push_back(fV18potThread);
+        V18PotThreadGeneration = V18PotGeneration;
+        }
+    }
+    unsigned StefPotId = V18Pot-1;
+    if(V18Pot==112) StefPotId=24;
+    else if(V18Pot==113) StefPotId=25;
+    else if(V18Pot==114) StefPotId=26;
+    else if(V18Pot==122) StefPotId=27;
+    else if(V18Pot==123) StefPotId=28;
+    else if(V18Pot==124) StefPotId=29;
+    if(!fV18potThread[StefPotId]){
+        fV18potThread[StefPotId] = new DLM_StefanoPotentials(V18Pot);
+    }
+    return fV18potThread[StefPotId];
 }
 
 double ZeroPotential(double* Radius){
@@ -1246,39 +1276,9 @@ double fV18potential(const int& V18Pot, const int& DlmPotFlag,
         return 0;
     }
 
-    #pragma omp critical
-    {
-    if(!fV18pot){
-        NumThreads_DLMPOT = 1;
-        NumThreads_DLMPOT = omp_get_num_procs();
-        fV18pot = new DLM_StefanoPotentials** [NumThreads_DLMPOT];
-        for(unsigned uThread=0; uThread<NumThreads_DLMPOT; uThread++){
-            fV18pot[uThread] = new DLM_StefanoPotentials* [30];
-            for(unsigned uPot=0; uPot<30; uPot++){
-                fV18pot[uThread][uPot] = NULL;
-            }
-        }
-    }
-    }
-
-
-    unsigned StefPotId = V18Pot-1;
-    if(V18Pot==112) StefPotId=24;
-    else if(V18Pot==113) StefPotId=25;
-    else if(V18Pot==114) StefPotId=26;
-    else if(V18Pot==122) StefPotId=27;
-    else if(V18Pot==123) StefPotId=28;
-    else if(V18Pot==124) StefPotId=29;
-    unsigned tid = 0;
-    tid = omp_get_thread_num();
-    if(!fV18pot[tid][StefPotId]){
-        fV18pot[tid][StefPotId] = new DLM_StefanoPotentials(V18Pot);
-    }
-
 //printf("StefPotId=%i --> V=%f\n",StefPotId,fV18pot[StefPotId]->EvalCATS_v1_0(Radius[0],0));
     //return fV18pot[StefPotId]->Eval_PWprojector_pp(Radius[0],Spin,AngMom,TotMom,DlmPotFlag);
-//printf("fV18pot[%u][%u]=%p\n",tid,StefPotId,fV18pot[tid][StefPotId]);
-    return fV18pot[tid][StefPotId]->Eval_PWprojector(Radius[0],IsoSpin,t2p1,t2p2,Spin,AngMom,TotMom,DlmPotFlag);
+    return GetV18Pot(V18Pot)->Eval_PWprojector(Radius[0],IsoSpin,t2p1,t2p2,Spin,AngMom,TotMom,DlmPotFlag);
     //return 0;
 }
 
@@ -1635,6 +1635,26 @@ double fDlmPotVer2(double* Parameters){
                    round(Parameters[6]),round(Parameters[7]),round(Parameters[8]),round(Parameters[9]),Parameters,Parameters[10],&Parameters[11]);
 }
 
+//batch versions of fDlmPot and fDlmPotVer2 (see CatsPotentialBatch), the integer flags are rounded only once for all radii
+void fDlmPotBatch(double* Parameters, const unsigned& NumPts, const double* Radius, double* Result){
+    const int DlmPot=round(Parameters[2]); const int DlmPotFlag=round(Parameters[3]); const int IsoSpin=round(Parameters[4]);
+    const int t2p1=round(Parameters[5]); const int t2p2=round(Parameters[6]);
+    const int Spin=round(Parameters[7]); const int AngMom=round(Parameters[8]); const int TotMom=round(Parameters[9]);
+    for(unsigned uPt=0; uPt<NumPts; uPt++){
+        Parameters[0] = Radius[uPt];
+        Result[uPt] = fDlmPot(DlmPot,DlmPotFlag,IsoSpin,t2p1,t2p2,Spin,AngMom,TotMom,Parameters,0,&Parameters[10]);
+    }
+}
+void fDlmPotVer2Batch(double* Parameters, const unsigned& NumPts, const double* Radius, double* Result){
+    const int DlmPot=round(Parameters[2]); const int DlmPotFlag=round(Parameters[3]); const int IsoSpin=round(Parameters[4]);
+    const int t2p1=round(Parameters[5]); const int t2p2=round(Parameters[6]);
+    const int Spin=round(Parameters[7]); const int AngMom=round(Parameters[8]); const int TotMom=round(Parameters[9]);
+    for(unsigned uPt=0; uPt<NumPts; uPt++){
+        Parameters[0] = Radius[uPt];
+        Result[uPt] = fDlmPot(DlmPot,DlmPotFlag,IsoSpin,t2p1,t2p2,Spin,AngMom,TotMom,Parameters,Parameters[10],&Parameters[11]);
+    }
+}
+
 //[2,3,4,5] = B1,2,3,4
 //[6] = mpi (pion mass)
 //[7] = cutoff
@@ -1659,17 +1679,12 @@ double LatticePots(double* Parameters){
 
 
 void GetDlmPotName(const int& potid, const int& potflag, char* name){
-    double Radius=1;
-    //fV18potential(1,0,0,0,&Radius);
-    fV18potential(1,0,1,1,1,0,0,0,&Radius);
-    unsigned tid = 0;
-    tid = omp_get_thread_num();
     switch(potid){
         case NN_AV18 :
-            fV18pot[tid][8]->PotentialName(9, name);
+            GetV18Pot(9)->PotentialName(9, name);
             break;
         case NN_ReidV8 :
-            fV18pot[tid][1]->PotentialName(2, name);
+            GetV18Pot(2)->PotentialName(2, name);
             break;
         case pp_ReidSC :
             strcpy(name,"Castrated Reid SC");
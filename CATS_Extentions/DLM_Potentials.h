@@ -86,6 +86,9 @@ double fDlmPot(const int& DlmPot, const int& DlmPotFlag, const int& IsoSpin, con
                double* Radius, const double& CutOff, double* OtherPars=NULL);
 double fDlmPot(double* Parameters);
 double fDlmPotVer2(double* Parameters);
+//batch versions, to be used with CATS::SetShortRangePotentialBatch
+void fDlmPotBatch(double* Parameters, const unsigned& NumPts, const double* Radius, double* Result);
+void fDlmPotVer2Batch(double* Parameters, const unsigned& NumPts, const double* Radius, double* Result);
 double LatticePots(double* Parameters);
 
 void GetDlmPotName(const int& potid, const int& potflag, char* name);
@@ -43,31 +43,30 @@ void DLM_ResponseMatrix::DefaultConstructor(){
             SparseResponse[iBin][yAxisLast] = -1;
         }
 
+        //Response[Y][X] = sum_K Sigma[Y][K]*Residual[K][X], where only the non-zero range of row Y of Sigma and of
+        //row K of Residual contribute. For each element the terms are added in the same order (ascending K) as in the full product
         for(int iBinY=0; iBinY<NumMomBins; iBinY++){
+            double* RespRow = ResponseMatrix[iBinY];
             for(int iBinX=0; iBinX<NumMomBins; iBinX++){
-                ResponseMatrix[iBinY][iBinX] = 0;
-                for(int iBinK=0; iBinK<NumMomBins; iBinK++){
-                    ResponseMatrix[iBinY][iBinX] += SigmaMatrix[iBinY][iBinK]*ResidualMatrix[iBinK][iBinX];
+                RespRow[iBinX] = 0;
+            }
+            for(int iBinK=SparseSigma[iBinY][xAxisFirst]; iBinK<=SparseSigma[iBinY][xAxisLast]; iBinK++){
+                const double& SigmaYK = SigmaMatrix[iBinY][iBinK];
+                if(SigmaYK==0) continue;
+                const double* ResidRow = ResidualMatrix[iBinK];
+                for(int iBinX=SparseResidual[iBinK][xAxisFirst]; iBinX<=SparseResidual[iBinK][xAxisLast]; iBinX++){
+                    RespRow[iBinX] += SigmaYK*ResidRow[iBinX];
                 }
             }
         }
-    }
-
-    for(int iBinY=0; iBinY<NumMomBins; iBinY++){
-        for(int iBinX=0; iBinX<NumMomBins; iBinX++){
+        //the first and last non-zero entry of each row and column, in a single pass over the matrix
+        for(int iBinY=0; iBinY<NumMomBins; iBinY++){
             for(int iBinX=0; iBinX<NumMomBins; iBinX++){
-                if(ResponseMatrix[iBinY][iBinX]!=0 && SparseResponse[iBinY][xAxisFirst]==-1){
-                    SparseResponse[iBinY][xAxisFirst] = iBinX;
-                }
-                if(ResponseMatrix[iBinY][iBinX]!=0 && SparseResponse[iBinX][yAxisFirst]==-1){
-                    SparseResponse[iBinX][yAxisFirst] = iBinY;
-                }
-                if(ResponseMatrix[iBinY][iBinX]!=0){
-                    SparseResponse[iBinY][xAxisLast] = iBinX;
-                }
-                if(ResponseMatrix[iBinY][iBinX]!=0){
-                    SparseResponse[iBinX][yAxisLast] = iBinY;
-                }
+                if(ResponseMatrix[iBinY][iBinX]==0) continue;
+                if(SparseResponse[iBinY][xAxisFirst]==-1) SparseResponse[iBinY][xAxisFirst] = iBinX;
+                if(SparseResponse[iBinX][yAxisFirst]==-1) SparseResponse[iBinX][yAxisFirst] = iBinY;
+                SparseResponse[iBinY][xAxisLast] = iBinX;
+                SparseResponse[iBinX][yAxisLast] = iBinY;
             }
         }
     }
@@ -84,6 +83,7 @@ DLM_ResponseMatrix::DLM_ResponseMatrix(CATS& ab, const DLM_Histo<float>* hs, con
     delete [] BINS;
 
     DefaultConstructor();
+    SetUpBand();
 }
 
 DLM_ResponseMatrix::DLM_ResponseMatrix(DLM_Histo<double>& ch, const DLM_Histo<float>* hs, const DLM_Histo<float>* hr, const bool& ia):
@@ -93,6 +93,7 @@ DLM_ResponseMatrix::DLM_ResponseMatrix(DLM_Histo<double>& ch, const DLM_Histo<fl
     CatHistoIsMyOwn = false;
 
     DefaultConstructor();
+    SetUpBand();
 }
 
 DLM_ResponseMatrix::~DLM_ResponseMatrix(){
@@ -110,6 +111,89 @@ DLM_ResponseMatrix::~DLM_ResponseMatrix(){
         delete CatHisto;
         CatHisto = NULL;
     }
+    delete [] BandResponse; BandResponse=NULL;
+    delete [] BandFirst; BandFirst=NULL;
+    delete [] BandOffset; BandOffset=NULL;
+}
+
+void DLM_ResponseMatrix::SetUpBand(){
+    BandFirst = new int [NumMomBins];
+    BandOffset = new unsigned [NumMomBins+1];
+    BandOffset[0] = 0;
+    //the same range as used in DLM_CkDecomp::Smear: an empty row has a negative first entry
+    for(int iBinY=0; iBinY<NumMomBins; iBinY++){
+        int FirstBin = SparseResponse[iBinY][xAxisFirst];
+        int LastBin = SparseResponse[iBinY][xAxisLast];
+        if(LastBin>=NumMomBins) LastBin = NumMomBins-1;
+        if(FirstBin<0 || LastBin<FirstBin){
+            FirstBin = 0;
+            LastBin = -1;
+        }
+        BandFirst[iBinY] = FirstBin;
+        BandOffset[iBinY+1] = BandOffset[iBinY]+unsigned(LastBin-FirstBin+1);
+    }
+    BandResponse = new double [BandOffset[NumMomBins]?BandOffset[NumMomBins]:1];
+    for(int iBinY=0; iBinY<NumMomBins; iBinY++){
+        double* Row = &BandResponse[BandOffset[iBinY]];
+        const int NumBand = BandOffset[iBinY+1]-BandOffset[iBinY];
+        for(int iBand=0; iBand<NumBand; iBand++){
+            const int iBinX = BandFirst[iBinY]+iBand;
+            //as the response matrix is normalized to the size of the bin, during the integration we multiply for it
+            Row[iBand] = ResponseMatrix[iBinY][iBinX]*CatHisto->GetBinSize(iBinX)*CatHisto->GetBinSize(iBinY);
+        }
+    }
+}
+
+bool DLM_ResponseMatrix::SameBinning(const DLM_Histo<double>* histo) const{
+    if(!histo) return false;
+    if(histo==CatHisto) return true;
+    if(histo->GetDim()!=1 || int(histo->GetNbins())!=NumMomBins) return false;
+    //the bin edges are compared directly (GetBinSize allocates memory on each call)
+    for(int iBin=0; iBin<=NumMomBins; iBin++){
+        if(histo->GetBinLowEdge(0,iBin)!=CatHisto->GetBinLowEdge(0,iBin)) return false;
+    }
+    return true;
+}
+
+void DLM_ResponseMatrix::Smear(const unsigned& NumHisto, const DLM_Histo<double>* const* CkToSmear, DLM_Histo<double>* const* CkSmeared) const{
+    if(!NumHisto) return;
+    //the input is copied to a [iBinX][uHisto] buffer, thus each element of the matrix is loaded only once for all histograms
+    double* Input = new double [NumMomBins*NumHisto];
+    double* Output = new double [NumHisto];
+    for(int iBinX=0; iBinX<NumMomBins; iBinX++){
+        for(unsigned uHisto=0; uHisto<NumHisto; uHisto++){
+            Input[iBinX*NumHisto+uHisto] = CkToSmear[uHisto]->GetBinContent(iBinX);
+        }
+    }
+    for(int iBinY=0; iBinY<NumMomBins; iBinY++){
+        const double* Row = &BandResponse[BandOffset[iBinY]];
+        const int NumBand = BandOffset[iBinY+1]-BandOffset[iBinY];
+        const double* In = &Input[BandFirst[iBinY]*NumHisto];
+        if(NumHisto==1){
+            double Sum=0;
+            #pragma omp simd reduction(+:Sum)
+            for(int iBand=0; iBand<NumBand; iBand++){
+                Sum += Row[iBand]*In[iBand];
+            }
+            Output[0] = Sum;
+        }
+        else{
+            for(unsigned uHisto=0; uHisto<NumHisto; uHisto++) Output[uHisto] = 0;
+            for(int iBand=0; iBand<NumBand; iBand++){
+                const double& Weight = Row[iBand];
+                const double* InBin = &In[iBand*NumHisto];
+                #pragma omp simd
+                for(unsigned uHisto=0; uHisto<NumHisto; uHisto++){
+                    Output[uHisto] += Weight*InBin[uHisto];
+                }
+            }
+        }
+        for(unsigned uHisto=0; uHisto<NumHisto; uHisto++){
+            CkSmeared[uHisto]->SetBinContent(iBinY, Output[uHisto]);
+        }
+    }
+    delete [] Input;
+    delete [] Output;
 }
 
 //allocates both the matrix and the sparse
@@ -203,28 +287,58 @@ void DLM_ResponseMatrix::ConvertMatrix(const int& WhichMatr, const DLM_Histo<flo
     int** Sparse = GetSparse(WhichMatr);
     double** Matrix = GetMatrix(WhichMatr);
 
-    double MomLowEdgeX;
-    double MomUpEdgeX;
-    double MomLowEdgeY;
-    double MomUpEdgeY;
-    int WhichBinAtLowEdgeX;
-    int WhichBinAtUpEdgeX;
-    int WhichBinAtLowEdgeY;
-    int WhichBinAtUpEdgeY;
-    int NumOldBinsX;
-    int NumOldBinsY;
-    const int MaxBufferSize = 1024;
-    //these guys are used to see what fraction of all counts in the bin we should take
-    //important when the binning is different in the cats object and in the matrix
-    //in the end we end up with a matrix containing the number of entries in a specific momenta ranges,
-    //which we normalize to 1 and eventually to the size of the 2D bin
-    double* WeightX = new double [MaxBufferSize];
-    double* WeightY = new double [MaxBufferSize];
-
     //if the axis are inverted
     const int Xaxis = InvAxis;
     const int Yaxis = !InvAxis;
 
+    //for each Ck bin along the X (Y) axis: the bin of the input histogram at the low edge, the number of histogram bins
+    //enclosed in the Ck bin and the weights of the first and last of them. The latter are used to see what fraction of
+    //all counts in the bin we should take, important when the binning is different in the cats object and in the matrix.
+    //In the end we end up with a matrix containing the number of entries in a specific momenta ranges,
+    //which we normalize to 1 and eventually to the size of the 2D bin.
+    //All of these depend on a single axis, thus they are computed only once
+    int* WhichBinAtLowEdge[2];
+    int* NumOldBins[2];
+    double* WeightFirst[2];
+    double* WeightLast[2];
+    for(int iAxis=0; iAxis<2; iAxis++){
+        WhichBinAtLowEdge[iAxis] = new int [NumMomBins];
+        NumOldBins[iAxis] = new int [NumMomBins];
+        WeightFirst[iAxis] = new double [NumMomBins];
+        WeightLast[iAxis] = new double [NumMomBins];
+        for(int iBin=0; iBin<NumMomBins; iBin++){
+            //the k values at the low/up bin edge
+            const double MomLowEdge = CatHisto->GetBinLowEdge(0,iBin);
+            const double MomUpEdge = CatHisto->GetBinUpEdge(0,iBin);
+            //the corresponding bin numbers in the smear histogram
+            const int WhichBinAtUpEdge = input->GetBin(iAxis,MomUpEdge);
+            WhichBinAtLowEdge[iAxis][iBin] = input->GetBin(iAxis,MomLowEdge);
+            //number of histogram bins that are enclosed in this interval
+            NumOldBins[iAxis][iBin] = WhichBinAtUpEdge - WhichBinAtLowEdge[iAxis][iBin] + 1;
+            WeightFirst[iAxis][iBin] = (input->GetBinUpEdge(iAxis,WhichBinAtLowEdge[iAxis][iBin])-MomLowEdge)/input->GetBinSize(iAxis,WhichBinAtLowEdge[iAxis][iBin]);
+            WeightLast[iAxis][iBin] = NumOldBins[iAxis][iBin]>1?(MomUpEdge-input->GetBinLowEdge(iAxis,WhichBinAtUpEdge))/input->GetBinSize(iAxis,WhichBinAtUpEdge):1;
+        }
+    }
+
+    //the first and last non-zero bin along the Y axis of the input histogram, for each of its bins along the X axis.
+    //Ck bins outside of this band are zero and are not integrated over
+    const int NumInputBinsX = input->GetNbins(Xaxis);
+    const int NumInputBinsY = input->GetNbins(Yaxis);
+    int* InputFirstY = new int [NumInputBinsX];
+    int* InputLastY = new int [NumInputBinsX];
+    for(int iOldBinX=0; iOldBinX<NumInputBinsX; iOldBinX++){
+        unsigned WhichBin[2];
+        WhichBin[Xaxis] = iOldBinX;
+        InputFirstY[iOldBinX] = NumInputBinsY;
+        InputLastY[iOldBinX] = -1;
+        for(int iOldBinY=0; iOldBinY<NumInputBinsY; iOldBinY++){
+            WhichBin[Yaxis] = iOldBinY;
+            if(input->GetBinContent(WhichBin)==0) continue;
+            if(InputFirstY[iOldBinX]==NumInputBinsY) InputFirstY[iOldBinX] = iOldBinY;
+            InputLastY[iOldBinX] = iOldBinY;
+        }
+    }
+
     for(int iBin=0; iBin<NumMomBins; iBin++){
         Sparse[iBin][xAxisFirst] = -1;
         Sparse[iBin][xAxisLast] = -2;
@@ -234,79 +348,56 @@ void DLM_ResponseMatrix::ConvertMatrix(const int& WhichMatr, const DLM_Histo<flo
 
     //iterate over the Ck bins (X)
     for(int iBinX=0; iBinX<NumMomBins; iBinX++){
-        //the k values at the low/up bin edge
-        MomLowEdgeX = CatHisto->GetBinLowEdge(0,iBinX);
-        MomUpEdgeX = CatHisto->GetBinUpEdge(0,iBinX);
-        //the corresponding bin numbers in the smear histogram
-        WhichBinAtLowEdgeX = input->GetBin(Xaxis,MomLowEdgeX);
-        WhichBinAtUpEdgeX = input->GetBin(Xaxis,MomUpEdgeX);
-        //number of histogram bins that are enclosed in this interval
-        NumOldBinsX = WhichBinAtUpEdgeX - WhichBinAtLowEdgeX + 1;
-//Printf("MomLowEdgeX=%f", MomLowEdgeX);
-//Printf("MomUpEdgeX=%f", MomUpEdgeX);
-//Printf("WhichBinAtLowEdgeX=%i", WhichBinAtLowEdgeX);
-//Printf("WhichBinAtUpEdgeX=%i", WhichBinAtUpEdgeX);
-//Printf("Xaxis->GetBinLowEdge(%i)=%f", iBinX, Xaxis->GetBinLowEdge(iBinX));
-//usleep(2000e3);
-        if(NumOldBinsX>MaxBufferSize){
-            printf("ERROR: DLM_ResponseMatrix::ConvertMatrix hates you since NumOldBinsX>MaxBufferSize\nA CRASH SHOULD FOLLOW!\n");
+        const int& FirstOldBinX = WhichBinAtLowEdge[Xaxis][iBinX];
+        const int& NumOldBinsX = NumOldBins[Xaxis][iBinX];
+        //the band along Y of the input histogram bins inside of this Ck bin. If some of them are under/overflow bins
+        //we keep the full range
+        int BandFirstY = 0;
+        int BandLastY = NumInputBinsY;
+        if(FirstOldBinX>=0 && FirstOldBinX+NumOldBinsX<=NumInputBinsX){
+            BandFirstY = NumInputBinsY;
+            BandLastY = -1;
+            for(int iOldBinX=FirstOldBinX; iOldBinX<FirstOldBinX+NumOldBinsX; iOldBinX++){
+                if(InputFirstY[iOldBinX]<BandFirstY) BandFirstY = InputFirstY[iOldBinX];
+                if(InputLastY[iOldBinX]>BandLastY) BandLastY = InputLastY[iOldBinX];
+            }
         }
         //iterate over the Ck bins (Y)
         for(int iBinY=0; iBinY<NumMomBins; iBinY++){
-            MomLowEdgeY = CatHisto->GetBinLowEdge(0,iBinY);
-            MomUpEdgeY = CatHisto->GetBinUpEdge(0,iBinY);
-            WhichBinAtLowEdgeY = input->GetBin(Yaxis,MomLowEdgeY);
-            WhichBinAtUpEdgeY = input->GetBin(Yaxis,MomUpEdgeY);
-            NumOldBinsY = WhichBinAtUpEdgeY - WhichBinAtLowEdgeY + 1;
-            if(NumOldBinsY>MaxBufferSize){
-                printf("ERROR: DLM_ResponseMatrix::ConvertMatrix hates you since NumOldBinsX>MaxBufferSize\nA CRASH SHOULD FOLLOW!\n");
-            }
-
-            for(int iOldBinX=1; iOldBinX<NumOldBinsX-1; iOldBinX++){
-                WeightX[iOldBinX] = 1;
-            }
-
-            WeightX[0] = (input->GetBinUpEdge(Xaxis,WhichBinAtLowEdgeX)-MomLowEdgeX)/input->GetBinSize(Xaxis,WhichBinAtLowEdgeX);
-            if(NumOldBinsX>1){
-                WeightX[NumOldBinsX-1] = (MomUpEdgeX-input->GetBinLowEdge(Xaxis,WhichBinAtUpEdgeX))/input->GetBinSize(Xaxis,WhichBinAtUpEdgeX);
-            }
-
-            for(int iOldBinY=1; iOldBinY<NumOldBinsY-1; iOldBinY++){
-                WeightY[iOldBinY] = 1;
-            }
-            WeightY[0] = (input->GetBinUpEdge(Yaxis,WhichBinAtLowEdgeY)-MomLowEdgeY)/input->GetBinSize(Yaxis,WhichBinAtLowEdgeY);
-            if(NumOldBinsY>1){
-                WeightY[NumOldBinsY-1] = (MomUpEdgeY-input->GetBinLowEdge(Yaxis,WhichBinAtUpEdgeY))/input->GetBinSize(Yaxis,WhichBinAtUpEdgeY);
-            }
-
+            const int& FirstOldBinY = WhichBinAtLowEdge[Yaxis][iBinY];
+            const int& NumOldBinsY = NumOldBins[Yaxis][iBinY];
             Matrix[iBinY][iBinX] = 0;
+            if(FirstOldBinY>=0 && FirstOldBinY+NumOldBinsY<=NumInputBinsY &&
+               (FirstOldBinY+NumOldBinsY-1<BandFirstY || FirstOldBinY>BandLastY)) continue;
+
             for(int iOldBinX=0; iOldBinX<NumOldBinsX; iOldBinX++){
                 unsigned WhichBin[2];
+                const double WeightX = iOldBinX==0?WeightFirst[Xaxis][iBinX]:iOldBinX==NumOldBinsX-1?WeightLast[Xaxis][iBinX]:1;
                 for(int iOldBinY=0; iOldBinY<NumOldBinsY; iOldBinY++){
-                    WhichBin[Xaxis] = WhichBinAtLowEdgeX+iOldBinX;
-                    WhichBin[Yaxis] = WhichBinAtLowEdgeY+iOldBinY;
-                    Matrix[iBinY][iBinX] += WeightX[iOldBinX]*WeightY[iOldBinY]*input->GetBinContent(WhichBin);
+                    const double WeightY = iOldBinY==0?WeightFirst[Yaxis][iBinY]:iOldBinY==NumOldBinsY-1?WeightLast[Yaxis][iBinY]:1;
+                    WhichBin[Xaxis] = FirstOldBinX+iOldBinX;
+                    WhichBin[Yaxis] = FirstOldBinY+iOldBinY;
+                    Matrix[iBinY][iBinX] += WeightX*WeightY*input->GetBinContent(WhichBin);
                 }
             }
-            if(Matrix[iBinY][iBinX]!=0 && Sparse[iBinY][xAxisFirst]==-1){
-                Sparse[iBinY][xAxisFirst] = iBinX;
-            }
-            if(Matrix[iBinY][iBinX]!=0 && Sparse[iBinX][yAxisFirst]==-1){
-                Sparse[iBinX][yAxisFirst] = iBinY;
-            }
             if(Matrix[iBinY][iBinX]!=0){
+                if(Sparse[iBinY][xAxisFirst]==-1) Sparse[iBinY][xAxisFirst] = iBinX;
+                if(Sparse[iBinX][yAxisFirst]==-1) Sparse[iBinX][yAxisFirst] = iBinY;
                 Sparse[iBinY][xAxisLast] = iBinX;
-            }
-            if(Matrix[iBinY][iBinX]!=0){
                 Sparse[iBinX][yAxisLast] = iBinY;
             }
-
         }
     }
     NormalizeMatrix(WhichMatr);
 
-    delete [] WeightX;
-    delete [] WeightY;
+    for(int iAxis=0; iAxis<2; iAxis++){
+        delete [] WhichBinAtLowEdge[iAxis];
+        delete [] NumOldBins[iAxis];
+        delete [] WeightFirst[iAxis];
+        delete [] WeightLast[iAxis];
+    }
+    delete [] InputFirstY;
+    delete [] InputLastY;
 }
 
 double DLM_ResponseMatrix::BilinearInterpolation(const double& x0, const double& y0,
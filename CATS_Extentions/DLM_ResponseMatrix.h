@@ -18,7 +18,7 @@ public:
 
     //by default the input matrices are supposed to be [Y][X]
     //with the X axis being the the original (unsmeared) momentum
-    const bool& InvertedAxis;
+    const bool InvertedAxis;
     const int NumMomBins;
 
 //! The residual matrix is actually the transverse. The reason is that this makes a better
@@ -37,9 +37,24 @@ public:
     int** SparseResponse;
 
     enum enumSparse { xAxisFirst, xAxisLast, yAxisFirst, yAxisLast };
+
+    //true if the histo has the same bins as CatHisto, i.e. it can be used with Smear
+    bool SameBinning(const DLM_Histo<double>* histo) const;
+    //smears NumHisto histograms in a single pass over the matrix: CkSmeared[i] = ResponseMatrix x CkToSmear[i],
+    //where the integration is weighted with the bin sizes. All histograms should have the binning of CatHisto (see SameBinning)
+    void Smear(const unsigned& NumHisto, const DLM_Histo<double>* const* CkToSmear, DLM_Histo<double>* const* CkSmeared) const;
+
 private:
 
+    //the non-zero part of each row of the ResponseMatrix, multiplied with the bin sizes along X and Y, stored contiguously.
+    //The row iBinY starts at the bin BandFirst[iBinY] and is saved between BandOffset[iBinY] and BandOffset[iBinY+1]
+    double* BandResponse;
+    int* BandFirst;
+    unsigned* BandOffset;
+
     void DefaultConstructor();
+    //sets up the BandResponse, should be called after the ResponseMatrix is final
+    void SetUpBand();
 
     void AllocateMatrix(const int& WhichMatr);
     void DeleteMatrix(const int& WhichMatr);
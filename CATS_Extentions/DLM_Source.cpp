@@ -122,6 +122,65 @@ double GaussCauchySource(double* Pars){
 
 }
 
+//batch versions of the sources above (see CatsSourceBatch), giving the same results (up to rounding, if the compiler contracts to FMA).
+//The parameter-dependent factors are computed only once, the loops over the radii have no branches and can be vectorized
+void GaussSourceBatch(double* Pars, const unsigned& NumPts, const double* Radius, const double* CosTheta, double* Result){
+    const double& Size = Pars[3];
+    const double Norm = pow(4.*Pi*Size*Size,-1.5);
+    const double Denom = 4.*Size*Size;
+    #pragma omp simd
+    for(unsigned uPt=0; uPt<NumPts; uPt++){
+        Result[uPt] = 4.*Pi*Radius[uPt]*Radius[uPt]*Norm*exp(-(Radius[uPt]*Radius[uPt])/Denom);
+    }
+}
+void CauchySourceBatch(double* Pars, const unsigned& NumPts, const double* Radius, const double* CosTheta, double* Result){
+    const double& Size = Pars[3];
+    const double Norm = 2.97*Size*sqrt(2);
+    const double Size2 = 0.125*2.97*2.97*Size*Size;
+    #pragma omp simd
+    for(unsigned uPt=0; uPt<NumPts; uPt++){
+        Result[uPt] = Norm*Radius[uPt]*Radius[uPt]/Pi*pow(Radius[uPt]*Radius[uPt]+Size2,-2.);
+    }
+}
+void CauchySourceThetaBatch(double* Pars, const unsigned& NumPts, const double* Radius, const double* CosTheta, double* Result){
+    CauchySourceBatch(Pars,NumPts,Radius,CosTheta,Result);
+    for(unsigned uPt=0; uPt<NumPts; uPt++) Result[uPt] *= 0.5;
+}
+void ExponentialSourceBatch(double* Pars, const unsigned& NumPts, const double* Radius, const double* CosTheta, double* Result){
+    const double& Size = Pars[3];
+    #pragma omp simd
+    for(unsigned uPt=0; uPt<NumPts; uPt++){
+        Result[uPt] = 4.*Radius[uPt]*Radius[uPt]*Size*pow(Radius[uPt]*Radius[uPt]+Size*Size,-2.);
+    }
+}
+void DoubleGaussSourceBatch(double* Pars, const unsigned& NumPts, const double* Radius, const double* CosTheta, double* Result){
+    const double& Size1 = Pars[3];
+    const double& Size2 = Pars[4];
+    const double& Weight1 = Pars[5];
+    const double Norm1 = pow(4.*Pi*Size1*Size1,-1.5);
+    const double Norm2 = pow(4.*Pi*Size2*Size2,-1.5);
+    const double Denom1 = 4.*Size1*Size1;
+    const double Denom2 = 4.*Size2*Size2;
+    #pragma omp simd
+    for(unsigned uPt=0; uPt<NumPts; uPt++){
+        Result[uPt] =   Weight1 *4.*Pi*Radius[uPt]*Radius[uPt]*Norm1*exp(-(Radius[uPt]*Radius[uPt])/Denom1)+
+                    (1.-Weight1)*4.*Pi*Radius[uPt]*Radius[uPt]*Norm2*exp(-(Radius[uPt]*Radius[uPt])/Denom2);
+    }
+}
+void GaussCauchySourceBatch(double* Pars, const unsigned& NumPts, const double* Radius, const double* CosTheta, double* Result){
+    const double& Size1 = Pars[3];
+    const double& Size2 = Pars[4];
+    const double& Weight1 = Pars[5];
+    const double Norm1 = pow(4.*Pi*Size1*Size1,-1.5);
+    const double Denom1 = 4.*Size1*Size1;
+    const double Size22 = 0.25*Size2*Size2;
+    #pragma omp simd
+    for(unsigned uPt=0; uPt<NumPts; uPt++){
+        Result[uPt] =   Weight1 *4.*Pi*Radius[uPt]*Radius[uPt]*Norm1*exp(-(Radius[uPt]*Radius[uPt])/Denom1)+
+                    (1.-Weight1)*2.*Size2*Radius[uPt]*Radius[uPt]/Pi*pow(Radius[uPt]*Radius[uPt]+Size22,-2.);
+    }
+}
+
 
 double LevyIntegral3D_2particle(double* Pars){
     //just a dummy, we do not expect angular dependence, but need the memory for the integration variable
@@ -328,12 +387,13 @@ double LevySource_A(double* Pars){
 //pars[6] = TAU
 //pars[7] = Temperature
 double GaussOSL_MC(double* Pars){
-    static DLM_CRAB_PM* PM1 = NULL;
-    static double Old_rOut;
-    static double Old_rSide;
-    static double Old_rLong;
-    static double Old_Tau;
-    static double Old_Temp;
+    //each thread keeps its own phasemaker and histograms
+    thread_local DLM_CRAB_PM* PM1 = NULL;
+    thread_local double Old_rOut;
+    thread_local double Old_rSide;
+    thread_local double Old_rLong;
+    thread_local double Old_Tau;
+    thread_local double Old_Temp;
     //bool SourceChanged = false;
     double& Radius = Pars[1];
     double& rOut = Pars[3];
@@ -341,11 +401,16 @@ double GaussOSL_MC(double* Pars){
     double& rLong = Pars[5];
     double& Tau = Pars[6];
     double& Temp = Pars[7];
-    static TH1F* hRO=NULL;
-    static TH1F* hRS=NULL;
-    static TH1F* hRL=NULL;
-    static TH1F* hTau=NULL;
-    if(!PM1 || Old_rOut!=rOut || Old_rSide!=rSide || Old_rLong!=rLong || Old_Tau!=Tau || Old_Temp!=Temp){
+    thread_local TH1F* hRO=NULL;
+    thread_local TH1F* hRS=NULL;
+    thread_local TH1F* hRL=NULL;
+    thread_local TH1F* hTau=NULL;
+    const bool Rebuild = !PM1 || Old_rOut!=rOut || Old_rSide!=rSide || Old_rLong!=rLong || Old_Tau!=Tau || Old_Temp!=Temp;
+    //the creation of the ROOT histograms (registered in gDirectory) and the phasemaker itself are not thread safe,
+    //the cache of this thread is checked without the lock
+    if(Rebuild)
+    #pragma omp critical(DLM_GaussOSL_MC)
+    {
         if(PM1) delete PM1;
         PM1 = new DLM_CRAB_PM();
         if(hRO) {delete hRO;}
@@ -428,11 +493,12 @@ double Gauss_Exp_Approx(double* Pars){
     double TKM = TKM1+TKM2;
     //double rMOM1 = sqrt(pow(MMass,4.)-2.*pow(MMass*Mass[0],2.)+pow(Mass[0],4.)-2.*pow(MMass*Mass[1],2.)-2.*pow(Mass[0]*Mass[1],2.)+pow(Mass[1],4.))/(2.*Mass[0]);
     double OldRad = RAD;
-    static double oldMOM = 0;
-    static double oldSIG = 0;
-    static double oldTKM = 0;
-    static double oldMASS = 0;
-    static double NORM = 1;
+    //thread_local, as several CATS objects can be evaluated concurrently (e.g. by DLM_Fitter1)
+    thread_local double oldMOM = 0;
+    thread_local double oldSIG = 0;
+    thread_local double oldTKM = 0;
+    thread_local double oldMASS = 0;
+    thread_local double NORM = 1;
     //this function is not normalized by default. This is done here. However we save information about the last time a normalization
     //was performed, if nothing has changed, this means NORM already has the correct value and we skip this rather expensive step
     if( (oldMOM!=MOM || oldSIG!=SIG || oldTKM!=TKM || oldMASS!=MASS) && NORM!=1.23456789 ){
@@ -540,10 +606,11 @@ double GaussExpSimple_Approx(double* Pars){
     double& TKM = Pars[4];
     //double rMOM1 = sqrt(pow(MMass,4.)-2.*pow(MMass*Mass[0],2.)+pow(Mass[0],4.)-2.*pow(MMass*Mass[1],2.)-2.*pow(Mass[0]*Mass[1],2.)+pow(Mass[1],4.))/(2.*Mass[0]);
     double OldRad = RAD;
-    static double oldMOM = 0;
-    static double oldSIG = 0;
-    static double oldTKM = 0;
-    static double NORM = 1;
+    //per thread, see Gauss_Exp_Approx
+    thread_local double oldMOM = 0;
+    thread_local double oldSIG = 0;
+    thread_local double oldTKM = 0;
+    thread_local double NORM = 1;
     //this function is not normalized by default. This is done here. However we save information about the last time a normalization
     //was performed, if nothing has changed, this means NORM already has the correct value and we skip this rather expensive step
     if( (oldMOM!=MOM || oldSIG!=SIG || oldTKM!=TKM ) && NORM!=1.23456789 ){
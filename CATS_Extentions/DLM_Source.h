@@ -20,6 +20,13 @@ double ExponentialSource(double* Pars);
 
 double DoubleGaussSource(double* Pars);
 double GaussCauchySource(double* Pars);
+//batch versions of the above, to be used with CATS::SetAnaSourceBatch
+void GaussSourceBatch(double* Pars, const unsigned& NumPts, const double* Radius, const double* CosTheta, double* Result);
+void CauchySourceBatch(double* Pars, const unsigned& NumPts, const double* Radius, const double* CosTheta, double* Result);
+void CauchySourceThetaBatch(double* Pars, const unsigned& NumPts, const double* Radius, const double* CosTheta, double* Result);
+void ExponentialSourceBatch(double* Pars, const unsigned& NumPts, const double* Radius, const double* CosTheta, double* Result);
+void DoubleGaussSourceBatch(double* Pars, const unsigned& NumPts, const double* Radius, const double* CosTheta, double* Result);
+void GaussCauchySourceBatch(double* Pars, const unsigned& NumPts, const double* Radius, const double* CosTheta, double* Result);
 //double LevyIntegral1D(double* Pars);
 double LevySource3D_2particle(double* Pars);
 double LevySource3D_single(double* Pars);
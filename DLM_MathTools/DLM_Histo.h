@@ -16,15 +16,21 @@ public:
         BinRange = NULL;
         BinValue = NULL;
         BinCenter = NULL;
+        InvBinWidth = 0;
         if(!NumBins){
             return;
         }
         BinRange = new Type [NumBins+1];
         BinValue = new Type [NumBins];
         BinCenter = new Type [NumBins];
+        //bins that are equidistant (up to the numerical precision) are treated as if set up with xmin,xmax
+        const Type MeanWidth = (bins[NumBins]-bins[0])/Type(NumBins);
+        bool Equidistant = MeanWidth>0;
         for(unsigned uBin=0; uBin<=NumBins; uBin++){
             BinRange[uBin] = bins[uBin];
+            if(uBin && fabs(bins[uBin]-bins[uBin-1]-MeanWidth)>1e-9*MeanWidth) Equidistant = false;
         }
+        if(Equidistant) InvBinWidth = Type(1)/MeanWidth;
         //for(unsigned uBin=0; uBin<NumBins; uBin++){
             //BinValue[uBin] = GetBinCenter(uBin);
         //}
@@ -33,6 +39,7 @@ public:
         BinRange = NULL;
         BinValue = NULL;
         BinCenter = NULL;
+        InvBinWidth = 0;
         if(!NumBins){
             return;
         }
@@ -46,6 +53,7 @@ public:
         }
         else{
             Type BinWidth = (xmax-xmin)/Type(NumBins);
+            if(BinWidth>0) InvBinWidth = Type(1)/BinWidth;
 //printf("NumBins=%u; BinWidth=%f;\n",NumBins,BinWidth);
             for(unsigned uBin=0; uBin<=NumBins; uBin++){
                 BinRange[uBin] = xmin + Type(uBin)*BinWidth;
@@ -62,6 +70,7 @@ public:
         BinRange = NULL;
         BinValue = NULL;
         BinCenter = NULL;
+        InvBinWidth = 0;
         if(!NumBins){
             return;
         }
@@ -106,6 +115,15 @@ public:
         //NumBins or NumBins+1, depending on if we have an underflow or overflow
         if(xVal<BinRange[0]) return NumBins;
         if(xVal>BinRange[NumBins]) return NumBins+1;
+        //equidistant bins: the bin is computed directly, the bisection below is used only if xVal is at a bin edge
+        if(InvBinWidth){
+            WhichBin = unsigned((xVal-BinRange[0])*InvBinWidth);
+            if(WhichBin>=NumBins) WhichBin = NumBins-1;
+            if(WhichBin && xVal<BinRange[WhichBin]) WhichBin--;
+            else if(WhichBin+1<NumBins && xVal>BinRange[WhichBin+1]) WhichBin++;
+            if(BinRange[WhichBin]<xVal && xVal<BinRange[WhichBin+1]) return WhichBin;
+            WhichBin=(NumBins+1)/2;
+        }
         while(true){
             if(BinRange[WhichBin]<=xVal && BinRange[WhichBin+1]>=xVal){
                 return WhichBin;
@@ -201,6 +219,7 @@ public:
             BinCenter[uBin] = other.BinCenter[uBin];
         }
         BinRange[NumBins] = other.BinRange[NumBins];
+        InvBinWidth = other.InvBinWidth;
 /*
         for(unsigned uBin=0; uBin<NumBins; uBin++){
             if(other.BinValue[uBin]>0.95452 && other.BinValue[uBin]<0.95453){
@@ -240,6 +259,7 @@ protected:
         BinRange = NULL;
         BinValue = NULL;
         BinCenter = NULL;
+        InvBinWidth = 0;
         if(!NumBins){
             return;
         }
@@ -252,6 +272,8 @@ protected:
     Type* BinRange;
     Type* BinValue;
     Type* BinCenter;
+    //1/BinWidth for equidistant bins, else 0
+    Type InvBinWidth;
 };
 
 
@@ -272,7 +294,11 @@ protected:
 
 
 
-template <class Type> class DLM_Histo{
+//FixedDim>0 is a histogram with a dimension fixed at compile time (see the end of the file),
+//the default FixedDim=0 is the general histogram with the dimension set at run time by SetUp
+template <class Type, unsigned short FixedDim=0> class DLM_Histo;
+
+template <class Type> class DLM_Histo<Type,0>{
 public:
     DLM_Histo(){
 //printf("DLM_Histo() %p\n",this);
@@ -299,6 +325,11 @@ public:
             printf("\033[1;31mERROR:\033[0m DLM_Histo cannot have 0 dimensions!\n");
             return;
         }
+        //Eval uses a bit per axis to enumerate the 2^Dim bins around the point
+        if(dim>31){
+            printf("\033[1;31mERROR:\033[0m DLM_Histo cannot have more than 31 dimensions!\n");
+            return;
+        }
         if(Dim==dim) return;
 
         CleanUp();
@@ -308,6 +339,7 @@ public:
         BinError = NULL;
         BinCenter = new double* [Dim];
         NumBins = new unsigned [Dim];
+        InvBinWidth = new double [Dim];
         //xValue = new Type* [Dim];
         //xBin = new unsigned* [Dim];
         //FunctionValue = new Type* [Dim];
@@ -318,6 +350,7 @@ public:
             //BinError[sDim]=0;
             BinCenter[sDim]=NULL;
             NumBins[sDim]=0;
+            InvBinWidth[sDim]=0;
             //xValue[sDim] = new Type[2];
             //xBin[sDim] = new unsigned[2];
             //FunctionValue[sDim] = new Type[2];
@@ -347,6 +380,9 @@ public:
         if(!BinRange[sDim]) BinRange[sDim] = new double[numbins+1];
         if(!BinCenter[sDim]) BinCenter[sDim] = new double[numbins];
         NumBins[sDim] = numbins;
+        //bins that are equidistant (up to the numerical precision) are treated as if set up with xmin,xmax
+        const double MeanWidth = (bins[numbins]-bins[0])/double(numbins);
+        bool Equidistant = MeanWidth>0;
         for(unsigned uBin=0; uBin<=NumBins[sDim]; uBin++){
             BinRange[sDim][uBin] = bins[uBin];
             if(uBin){
@@ -356,9 +392,11 @@ public:
                 else{
                     BinCenter[sDim][uBin-1] = (bins[uBin-1]+bins[uBin])*0.5;
                 }
+                if(fabs(bins[uBin]-bins[uBin-1]-MeanWidth)>1e-9*MeanWidth) Equidistant = false;
             }
 
         }
+        InvBinWidth[sDim] = Equidistant?1./MeanWidth:0;
     }
     void SetUp(const unsigned short& sDim, const unsigned& numbins, const double& xmin, const double& xmax){
         if(sDim>=Dim) return;
@@ -376,6 +414,7 @@ public:
         if(!BinRange[sDim]) BinRange[sDim] = new double[numbins+1];
         if(!BinCenter[sDim]) BinCenter[sDim] = new double[numbins];
         NumBins[sDim] = numbins;
+        InvBinWidth[sDim] = double(NumBins[sDim])/(xmax-xmin);
         if(NumBins[sDim]==1){
             BinRange[sDim][0] = xmin;
             BinRange[sDim][1] = xmax;
@@ -422,15 +461,7 @@ public:
         return true;
     }
     unsigned GetTotBin(const unsigned* WhichBin) const{
-        if(!Initialized) {InitWarning(); return 0;}
-        unsigned TotBin=0;
-        unsigned Base=1;
-        for(unsigned short sDim=0; sDim<Dim; sDim++){
-            if(WhichBin[sDim]>=NumBins[sDim]) return TotNumBins;
-            TotBin+=Base*WhichBin[sDim];
-            Base*=NumBins[sDim];
-        }
-        return TotBin;
+        return GetTotBinN<0>(WhichBin);
     }
     //BinIdPerAxis[sDim] -> saves for each dim the bin number
     void GetBinCoordinates(const unsigned& WhichTotBin, unsigned* BinIdPerAxis) const{
@@ -596,6 +627,7 @@ public:
             BinCenter[sDim][uBin] *= scale;
         }
         BinRange[sDim][NumBins[sDim]] *= scale;
+        InvBinWidth[sDim] = scale>0?InvBinWidth[sDim]/scale:0;
         if(binwidth){
             for(unsigned uBin=0; uBin<TotNumBins; uBin++){
                 BinValue[uBin] /= scale;
@@ -793,6 +825,16 @@ public:
         //NumBins or NumBins+1, depending on if we have an underflow or overflow
         if(xVal<BinRange[sDim][0]) return NumBins[sDim];
         if(xVal>BinRange[sDim][NumBins[sDim]]) return NumBins[sDim]+1;
+        //equidistant bins: the bin is computed directly, the bisection below is used only if xVal is
+        //at a bin edge (or the rounding places it in the neighbouring bin)
+        if(InvBinWidth[sDim]){
+            WhichBin = unsigned((xVal-BinRange[sDim][0])*InvBinWidth[sDim]);
+            if(WhichBin>=NumBins[sDim]) WhichBin = NumBins[sDim]-1;
+            if(WhichBin && xVal<BinRange[sDim][WhichBin]) WhichBin--;
+            else if(WhichBin+1<NumBins[sDim] && xVal>BinRange[sDim][WhichBin+1]) WhichBin++;
+            if(BinRange[sDim][WhichBin]<xVal && xVal<BinRange[sDim][WhichBin+1]) return WhichBin;
+            WhichBin=(NumBins[sDim]+1)/2;
+        }
         while(true){
             if(BinRange[sDim][WhichBin]<=xVal && BinRange[sDim][WhichBin+1]>=xVal){
                 return WhichBin;
@@ -918,135 +960,13 @@ public:
     }
 
     Type Eval(const double* xVal, const bool& EvalTheError=false) const{
-        if(!Initialized) {InitWarning(); return 0;}
-        //this is here to make it thread-safe, but maybe hinders performance???
-        double* xValue1 = new double [Dim];
-        double* xValue2 = new double [Dim];
-        double* DeltaX1 = new double [Dim];
-        double* DeltaX2 = new double [Dim];
-        unsigned* xBin1 = new unsigned [Dim];
-        unsigned* xBin2 = new unsigned [Dim];
-        //Type* FunctionValue1 = new Type [Dim];
-        //Type* FunctionValue2 = new Type [Dim];
-        //Type Normalization = new Type* [Dim];
-        //Type TotalNorm=0;
-
-        for(unsigned short sDim=0; sDim<Dim; sDim++){
-            //xBin[sDim] = new Type [2];
-            //xValue[sDim] = unsigned Type [2];
-            //FunctionValue[sDim] = new Type [2];
-            //Normalization[sDim] = new Type [2];
-
-            xBin1[sDim] = GetBin(sDim,xVal[sDim]);
-            xValue1[sDim] = GetBinCenter(sDim,xBin1[sDim]);
-            if(NumBins[sDim]==1){
-                //set as dummy only one of the x-values with weight zero,
-                //this way the value of x2 will actually play no role
-                //despite of that just in case we set x1=x2
-                xBin1[sDim]=0;
-                xBin2[sDim]=0;
-                xValue1[sDim]=GetBinCenter(sDim,0);
-                xValue2[sDim]=GetBinCenter(sDim,0);
-                DeltaX1[sDim]=0;
-                DeltaX2[sDim]=1;
-            }
-            else if(xVal[sDim]==xValue1[sDim]){
-                xBin2[sDim]=xBin1[sDim];
-                xValue2[sDim]=xValue1[sDim];
-                DeltaX1[sDim]=0;
-                DeltaX2[sDim]=1;
-            }
-            //we take this and the previous bin
-            //this is the case when:
-            //a) xVal is smaller than the bin center and there is a lower bin available
-            //b) in case we are in the last bin
-            else if( (xVal[sDim]<xValue1[sDim]&&xBin1[sDim]>0&&xBin1[sDim]<NumBins[sDim]) || xBin1[sDim]==NumBins[sDim]-1 ){
-                xBin2[sDim]=xBin1[sDim];
-                xBin1[sDim]=xBin1[sDim]-1;
-                xValue1[sDim] = GetBinCenter(sDim,xBin1[sDim]);
-                xValue2[sDim] = GetBinCenter(sDim,xBin2[sDim]);
-                DeltaX1[sDim]=xVal[sDim]-xValue1[sDim];
-                DeltaX2[sDim]=xValue2[sDim]-xVal[sDim];
-            }
-            //we take this and the next bin
-            //this is the case when:
-            //a) xVal is larger than the bin center and there is an upper bin available
-            //b) in case we are in the first bin or below
-            else if( (xVal[sDim]>xValue1[sDim]&&xBin1[sDim]<NumBins[sDim]-1) || xBin1[sDim]==0 ){
-                xBin2[sDim]=xBin1[sDim]+1;
-                xValue1[sDim] = GetBinCenter(sDim,xBin1[sDim]);
-                xValue2[sDim] = GetBinCenter(sDim,xBin2[sDim]);
-                DeltaX1[sDim]=xVal[sDim]-xValue1[sDim];
-                DeltaX2[sDim]=xValue2[sDim]-xVal[sDim];
-            }
-            //if we are in the overflow bin
-            else if(xBin1[sDim]==NumBins[sDim]+1){
-                xBin1[sDim]=NumBins[sDim]-2;
-                xBin2[sDim]=NumBins[sDim]-1;
-                xValue1[sDim] = GetBinCenter(sDim,xBin1[sDim]);
-                xValue2[sDim] = GetBinCenter(sDim,xBin2[sDim]);
-                DeltaX1[sDim]=xVal[sDim]-xValue1[sDim];
-                DeltaX2[sDim]=xValue2[sDim]-xVal[sDim];
-            }
-            //if we are in the underflow bin
-            else if(xBin1[sDim]==NumBins[sDim]){
-                xBin1[sDim]=0;
-                xBin2[sDim]=1;
-                xValue1[sDim] = GetBinCenter(sDim,xBin1[sDim]);
-                xValue2[sDim] = GetBinCenter(sDim,xBin2[sDim]);
-                DeltaX1[sDim]=xVal[sDim]-xValue1[sDim];
-                DeltaX2[sDim]=xValue2[sDim]-xVal[sDim];
-            }
-            else{
-                printf("This should not happen, unless there is a bug in DLM_Histo::Eval()\n");
-            }
-//if(TEMP){
-//printf("sDim=%u\n",sDim);
-//printf(" xVal=%f\n",xVal[sDim]);
-//printf(" xBin1=%u\n",xBin1[sDim]);
-//printf(" xBin2=%u\n",xBin2[sDim]);
-//printf(" xValue1=%f\n",xValue1[sDim]);
-//printf(" xValue2=%f\n",xValue2[sDim]);
-//printf(" DeltaX1=%f\n",DeltaX1[sDim]);
-//printf(" DeltaX2=%f\n",DeltaX2[sDim]);
-//}
-        }
-        Type Result=0;
-        unsigned* BinArray = new unsigned [Dim];
-        Type Weight=1;
-        Type Norm=0;
-        for(unsigned uPer=0; uPer<NumPermutations; uPer++){
-            Weight=1;
-            for(unsigned short sDim=0; sDim<Dim; sDim++){
-                if(PER[uPer][sDim]==0){
-                    BinArray[sDim]=xBin1[sDim];
-                    Weight*=DeltaX2[sDim];
-                }
-                else{
-                    BinArray[sDim]=xBin2[sDim];
-                    Weight*=DeltaX1[sDim];
-                }
-            }
-            if(EvalTheError){Result += GetBinError(BinArray)*Weight;}
-            else{Result += GetBinContent(BinArray)*Weight;}
-            Norm += Weight;
-        }
-        Result /= Norm;
-//if(TEMP){
-//unsigned BINARRAY[Dim];
-//BINARRAY[0] = GetBin(0,xVal[0]);
-//BINARRAY[1] = GetBin(1,xVal[1]);
-//printf(" --> RESULT=%f (%f); NORM=%f\n",abs(Result),abs(GetBinContent(BINARRAY)),abs(Norm));
-//}
-        delete [] xValue1;
-        delete [] xValue2;
-        delete [] xBin1;
-        delete [] xBin2;
-        delete [] DeltaX1;
-        delete [] DeltaX2;
-        delete [] BinArray;
-
-        return Result;
+        return EvalN<0>(xVal,EvalTheError);
+    }
+    //evaluates NumPts points at once, xVal[uPt*Dim+sDim], and saves the values in Result[uPt].
+    //The result is the same as calling Eval for each point, but the search for the bins starts from
+    //the bins of the previous point, i.e. this is fastest if the points are sorted.
+    void Eval(const unsigned& NumPts, const double* xVal, Type* Result, const bool& EvalTheError=false) const{
+        EvalN<0>(NumPts,xVal,Result,EvalTheError);
     }
 
     Type EvalError(const double* xVal) const{
@@ -1072,6 +992,7 @@ public:
                 BinCenter[sDim][uBin] = other.BinCenter[sDim][uBin];
             }
             BinRange[sDim][NumBins[sDim]] = other.BinRange[sDim][NumBins[sDim]];
+            InvBinWidth[sDim] = other.InvBinWidth[sDim];
         }
         for(unsigned uBin=0; uBin<TotNumBins; uBin++){
             BinValue[uBin] = other.BinValue[uBin];
@@ -1165,6 +1086,7 @@ protected:
         BinError = NULL;
         BinCenter = NULL;
         NumBins = NULL;
+        InvBinWidth = NULL;
         TotNumBins=0;
         PER = NULL;
         Initialized=false;
@@ -1196,6 +1118,7 @@ protected:
         }
 //printf("CU: NumBins\n");
         delete [] NumBins; NumBins=NULL;
+        delete [] InvBinWidth; InvBinWidth=NULL;
 //printf("CU: PER\n");
         if(PER){
             for(unsigned uPer=0; uPer<NumPermutations; uPer++){
@@ -1233,6 +1156,212 @@ protected:
         return true;
     }
 
+    //the implementation of GetTotBin and Eval, NDIM>0 is the number of dimensions known at compile time
+    //(FixedDim), which allows the compiler to unroll all loops over the axes. NDIM=0 uses Dim.
+    template <unsigned short NDIM> unsigned GetTotBinN(const unsigned* WhichBin) const{
+        if(!Initialized) {InitWarning(); return 0;}
+        const unsigned short NumDim = NDIM?NDIM:Dim;
+        unsigned TotBin=0;
+        unsigned Base=1;
+        for(unsigned short sDim=0; sDim<NumDim; sDim++){
+            if(WhichBin[sDim]>=NumBins[sDim]) return TotNumBins;
+            TotBin+=Base*WhichBin[sDim];
+            Base*=NumBins[sDim];
+        }
+        return TotBin;
+    }
+    template <unsigned short NDIM> Type EvalN(const double* xVal, const bool& EvalTheError) const{
+        if(!Initialized) {InitWarning(); return 0;}
+        const unsigned short NumDim = NDIM?NDIM:Dim;
+        //the temporary arrays are on the stack, only above MaxEvalDim dimensions they are allocated
+        double StackD[4*MaxEvalDim] = {};
+        unsigned StackU[5*MaxEvalDim] = {};
+        const bool OnHeap = NumDim>MaxEvalDim;
+        double* dWork = OnHeap?new double [4*NumDim]:StackD;
+        unsigned* uWork = OnHeap?new unsigned [5*NumDim]:StackU;
+        unsigned* xBin = &uWork[4*NumDim];
+        for(unsigned short sDim=0; sDim<NumDim; sDim++){
+            xBin[sDim] = GetBin(sDim,xVal[sDim]);
+        }
+        const Type Result = EvalStencil<NDIM>(xVal,xBin,EvalTheError,dWork,uWork);
+        if(OnHeap){delete [] dWork; delete [] uWork;}
+        return Result;
+    }
+    template <unsigned short NDIM> void EvalN(const unsigned& NumPts, const double* xVal, Type* Result, const bool& EvalTheError) const{
+        if(!Initialized) {InitWarning(); return;}
+        const unsigned short NumDim = NDIM?NDIM:Dim;
+        double StackD[4*MaxEvalDim] = {};
+        unsigned StackU[5*MaxEvalDim] = {};
+        const bool OnHeap = NumDim>MaxEvalDim;
+        double* dWork = OnHeap?new double [4*NumDim]:StackD;
+        unsigned* uWork = OnHeap?new unsigned [5*NumDim]:StackU;
+        unsigned* xBin = &uWork[4*NumDim];
+        for(unsigned uPt=0; uPt<NumPts; uPt++){
+            const double* xPt = &xVal[uPt*NumDim];
+            for(unsigned short sDim=0; sDim<NumDim; sDim++){
+                xBin[sDim] = uPt?GetBin(sDim,xPt[sDim],xBin[sDim]):GetBin(sDim,xPt[sDim]);
+            }
+            Result[uPt] = EvalStencil<NDIM>(xPt,xBin,EvalTheError,dWork,uWork);
+        }
+        if(OnHeap){delete [] dWork; delete [] uWork;}
+    }
+
+    //the same as GetBin, but the search starts from a bin close to the expected result (Guess).
+    //In case xVal is at the edge of two bins, the default GetBin is used to have exactly the same result.
+    unsigned GetBin(const unsigned short& sDim, const double& xVal, const unsigned& Guess) const{
+        if(NumBins[sDim]<=1 || Guess>=NumBins[sDim]) return GetBin(sDim,xVal);
+        const double* Range = BinRange[sDim];
+        if(xVal<Range[0]) return NumBins[sDim];
+        if(xVal>Range[NumBins[sDim]]) return NumBins[sDim]+1;
+        unsigned Low;
+        unsigned Up;
+        unsigned Step=1;
+        //first we find an interval Range[Low]<=xVal<=Range[Up] with steps increasing as 2^n
+        if(Range[Guess]<=xVal){
+            Low = Guess;
+            Up = Guess+1;
+            while(Range[Up]<xVal){
+                Low = Up;
+                Up = Low+Step<NumBins[sDim]?Low+Step:NumBins[sDim];
+                Step *= 2;
+            }
+        }
+        else{
+            Up = Guess;
+            Low = Guess-1;
+            while(xVal<Range[Low]){
+                Up = Low;
+                Low = Up>Step?Up-Step:0;
+                Step *= 2;
+            }
+        }
+        //than a bisection within this interval
+        while(Up-Low>1){
+            unsigned Mid = (Low+Up)/2;
+            if(Range[Mid]<=xVal) Low = Mid;
+            else Up = Mid;
+        }
+        if( (xVal==Range[Low]&&Low) || (xVal==Range[Up]&&Up<NumBins[sDim]) ) return GetBin(sDim,xVal);
+        return Low;
+    }
+
+    //the linear interpolation between the 2^Dim bins surrounding xVal, xBin is the result of GetBin for each axis.
+    //dWork and uWork are temporary arrays of (at least) 4*Dim elements
+    template <unsigned short NDIM> Type EvalStencil(const double* xVal, const unsigned* xBin, const bool& EvalTheError,
+                                                    double* dWork, unsigned* uWork) const{
+        const unsigned short NumDim = NDIM?NDIM:Dim;
+        const unsigned NumPer = NDIM?(1u<<NDIM):NumPermutations;
+        double* xValue1 = dWork;
+        double* xValue2 = &dWork[NumDim];
+        double* DeltaX1 = &dWork[2*NumDim];
+        double* DeltaX2 = &dWork[3*NumDim];
+        unsigned* xBin1 = uWork;
+        unsigned* xBin2 = &uWork[NumDim];
+        //the contribution of each axis to the total bin number
+        unsigned* TotBin1 = &uWork[2*NumDim];
+        unsigned* TotBin2 = &uWork[3*NumDim];
+        //the bit sDim is set if xBin1 (xBin2) is outside of the range of axis sDim (SetUp allows at most 31 axes)
+        unsigned Outside1=0;
+        unsigned Outside2=0;
+        unsigned Base=1;
+
+        for(unsigned short sDim=0; sDim<NumDim; sDim++){
+            xBin1[sDim] = xBin[sDim];
+            xValue1[sDim] = GetBinCenter(sDim,xBin1[sDim]);
+            if(NumBins[sDim]==1){
+                //set as dummy only one of the x-values with weight zero,
+                //this way the value of x2 will actually play no role
+                //despite of that just in case we set x1=x2
+                xBin1[sDim]=0;
+                xBin2[sDim]=0;
+                xValue1[sDim]=GetBinCenter(sDim,0);
+                xValue2[sDim]=GetBinCenter(sDim,0);
+                DeltaX1[sDim]=0;
+                DeltaX2[sDim]=1;
+            }
+            else if(xVal[sDim]==xValue1[sDim]){
+                xBin2[sDim]=xBin1[sDim];
+                xValue2[sDim]=xValue1[sDim];
+                DeltaX1[sDim]=0;
+                DeltaX2[sDim]=1;
+            }
+            //we take this and the previous bin
+            //this is the case when:
+            //a) xVal is smaller than the bin center and there is a lower bin available
+            //b) in case we are in the last bin
+            else if( (xVal[sDim]<xValue1[sDim]&&xBin1[sDim]>0&&xBin1[sDim]<NumBins[sDim]) || xBin1[sDim]==NumBins[sDim]-1 ){
+                xBin2[sDim]=xBin1[sDim];
+                xBin1[sDim]=xBin1[sDim]-1;
+                xValue1[sDim] = GetBinCenter(sDim,xBin1[sDim]);
+                xValue2[sDim] = GetBinCenter(sDim,xBin2[sDim]);
+                DeltaX1[sDim]=xVal[sDim]-xValue1[sDim];
+                DeltaX2[sDim]=xValue2[sDim]-xVal[sDim];
+            }
+            //we take this and the next bin
+            //this is the case when:
+            //a) xVal is larger than the bin center and there is an upper bin available
+            //b) in case we are in the first bin or below
+            else if( (xVal[sDim]>xValue1[sDim]&&xBin1[sDim]<NumBins[sDim]-1) || xBin1[sDim]==0 ){
+                xBin2[sDim]=xBin1[sDim]+1;
+                xValue1[sDim] = GetBinCenter(sDim,xBin1[sDim]);
+                xValue2[sDim] = GetBinCenter(sDim,xBin2[sDim]);
+                DeltaX1[sDim]=xVal[sDim]-xValue1[sDim];
+                DeltaX2[sDim]=xValue2[sDim]-xVal[sDim];
+            }
+            //if we are in the overflow bin
+            else if(xBin1[sDim]==NumBins[sDim]+1){
+                xBin1[sDim]=NumBins[sDim]-2;
+                xBin2[sDim]=NumBins[sDim]-1;
+                xValue1[sDim] = GetBinCenter(sDim,xBin1[sDim]);
+                xValue2[sDim] = GetBinCenter(sDim,xBin2[sDim]);
+                DeltaX1[sDim]=xVal[sDim]-xValue1[sDim];
+                DeltaX2[sDim]=xValue2[sDim]-xVal[sDim];
+            }
+            //if we are in the underflow bin
+            else if(xBin1[sDim]==NumBins[sDim]){
+                xBin1[sDim]=0;
+                xBin2[sDim]=1;
+                xValue1[sDim] = GetBinCenter(sDim,xBin1[sDim]);
+                xValue2[sDim] = GetBinCenter(sDim,xBin2[sDim]);
+                DeltaX1[sDim]=xVal[sDim]-xValue1[sDim];
+                DeltaX2[sDim]=xValue2[sDim]-xVal[sDim];
+            }
+            else{
+                printf("This should not happen, unless there is a bug in DLM_Histo::Eval()\n");
+            }
+            if(xBin1[sDim]>=NumBins[sDim]) Outside1 |= (1u<<sDim);
+            if(xBin2[sDim]>=NumBins[sDim]) Outside2 |= (1u<<sDim);
+            TotBin1[sDim] = Base*xBin1[sDim];
+            TotBin2[sDim] = Base*xBin2[sDim];
+            Base *= NumBins[sDim];
+        }
+        Type Result=0;
+        Type Weight=1;
+        Type Norm=0;
+        //the bit sDim of uPer decides if xBin1 or xBin2 is used for axis sDim (same as PER[uPer][sDim])
+        for(unsigned uPer=0; uPer<NumPer; uPer++){
+            Weight=1;
+            unsigned TotBin=0;
+            for(unsigned short sDim=0; sDim<NumDim; sDim++){
+                if(((uPer>>sDim)&1)==0){
+                    TotBin += TotBin1[sDim];
+                    Weight*=DeltaX2[sDim];
+                }
+                else{
+                    TotBin += TotBin2[sDim];
+                    Weight*=DeltaX1[sDim];
+                }
+            }
+            //same as GetTotBin, a bin outside the range of any axis is mapped to TotNumBins
+            if( (Outside1&~uPer) | (Outside2&uPer) ) TotBin = TotNumBins;
+            if(EvalTheError){Result += GetBinError(TotBin)*Weight;}
+            else{Result += GetBinContent(TotBin)*Weight;}
+            Norm += Weight;
+        }
+        Result /= Norm;
+        return Result;
+    }
+
     void InitPER(){
         NumPermutations = 1;
         for(unsigned short sDim=0; sDim<Dim; sDim++){
@@ -1269,6 +1398,8 @@ protected:
     unsigned TotNumBins;
     unsigned* NumBins;
     double** BinRange;
+    //for equidistant axes (SetUp with xmin,xmax) 1/BinWidth, else 0
+    double* InvBinWidth;
     //the last two bins are under/overflow
     Type* BinValue;
     Type* BinError;
@@ -1276,7 +1407,69 @@ protected:
 
     unsigned NumPermutations;
     char** PER;
+    //up to this number of dimensions the temporary arrays of Eval are kept on the stack, above they are allocated
+    static const unsigned short MaxEvalDim = 16;
 
     bool Initialized;
 };
+
+//a histogram with a dimension fixed at compile time, e.g. DLM_Histo<double,2>. The functions used for the evaluation
+//(GetTotBin, GetBinContent/GetBinError of a bin per axis and Eval) have loops over the axes with a known length,
+//which are unrolled by the compiler. It can be passed on to anything that expects the general DLM_Histo<Type>.
+template <class Type, unsigned short FixedDim> class DLM_Histo : public DLM_Histo<Type,0>{
+    //Eval uses a bit per axis to enumerate the 2^FixedDim bins around the point
+    static_assert(FixedDim<32,"DLM_Histo: FixedDim is too large");
+public:
+    DLM_Histo():DLM_Histo<Type,0>(){
+        DLM_Histo<Type,0>::SetUp(FixedDim);
+    }
+    DLM_Histo(const DLM_Histo& other):DLM_Histo(){
+        DLM_Histo<Type,0>::operator=(other);
+    }
+    DLM_Histo(const DLM_Histo<Type,0>& other):DLM_Histo(){
+        operator=(other);
+    }
+
+    using DLM_Histo<Type,0>::SetUp;
+    using DLM_Histo<Type,0>::GetBinContent;
+    using DLM_Histo<Type,0>::GetBinError;
+    using DLM_Histo<Type,0>::Eval;
+
+    //the dimension can not be changed
+    void SetUp(const unsigned short& dim){
+        if(dim!=FixedDim){
+            printf("\033[1;31mERROR:\033[0m DLM_Histo<Type,%u> cannot have %u dimensions!\n",FixedDim,dim);
+        }
+    }
+    bool operator=(const DLM_Histo& other){
+        return DLM_Histo<Type,0>::operator=(other);
+    }
+    bool operator=(const DLM_Histo<Type,0>& other){
+        if(other.GetDim()!=FixedDim){
+            printf("\033[1;31mERROR:\033[0m DLM_Histo<Type,%u> cannot be set equal to a histogram with %u dimensions!\n",FixedDim,other.GetDim());
+            return false;
+        }
+        return DLM_Histo<Type,0>::operator=(other);
+    }
+
+    unsigned GetTotBin(const unsigned* WhichBin) const{
+        return this->template GetTotBinN<FixedDim>(WhichBin);
+    }
+    Type GetBinContent(const unsigned* WhichBin) const{
+        return GetBinContent(GetTotBin(WhichBin));
+    }
+    Type GetBinError(const unsigned* WhichBin) const{
+        return GetBinError(GetTotBin(WhichBin));
+    }
+    Type Eval(const double* xVal, const bool& EvalTheError=false) const{
+        return this->template EvalN<FixedDim>(xVal,EvalTheError);
+    }
+    void Eval(const unsigned& NumPts, const double* xVal, Type* Result, const bool& EvalTheError=false) const{
+        this->template EvalN<FixedDim>(NumPts,xVal,Result,EvalTheError);
+    }
+    Type EvalError(const double* xVal) const{
+        return Eval(xVal,true);
+    }
+};
+
 #endif
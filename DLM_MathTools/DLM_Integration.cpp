@@ -3,10 +3,12 @@
 #include <stdio.h>
 #include <math.h>
 
-double (*DLM_INT_TEMP_FUN1)(const double& x);
-double (*DLM_INT_TEMP_FUN2)(double* par);
-double* DLM_INT_TEMP_PAR;
-unsigned DLM_INT_TEMP_N;
+//the function set for the integration is kept per thread, such that functions integrating
+//something internally (e.g. the normalization of some of the sources) can be evaluated in parallel
+thread_local double (*DLM_INT_TEMP_FUN1)(const double& x)=NULL;
+thread_local double (*DLM_INT_TEMP_FUN2)(double* par)=NULL;
+thread_local double* DLM_INT_TEMP_PAR=NULL;
+thread_local unsigned DLM_INT_TEMP_N=0;
 
 void DLM_INT_SetFunction(double (*f)(const double&)){
     DLM_INT_TEMP_FUN1 = f;